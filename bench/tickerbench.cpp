@@ -0,0 +1,624 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+/*
+ * Headless benchmarks for the rasterize / compose / scroll hot paths.
+ *
+ *   generate  StringImageCreater::generate() across message lengths, fonts,
+ *             pixel sizes and scripts, with and without the glyph atlas and
+ *             the shaped text cache
+ *   frame     one engine frame (tick, compose, present) per iteration at 1080p and
+ *             4K strip sizes, for a scrolling message and a live symbol board,
+ *             with full repaints and with scroll-blit
+ *   composite every compositing kernel set this CPU can run on a 4K strip,
+ *             with its throughput and whether it matches the scalar reference
+ *   outputs   one TickerEngine frame driving 1 to 8 mirrored 1080p windows,
+ *             serially and with parallel outputs
+ *   board     the per-frame layout, culling and replay of a symbol board with
+ *             1k to 100k items while 1% of them change width every frame
+ *   uploads   a 1080p frame with texture uploads on, for a scrolling message
+ *             and a live symbol board: time and bytes uploaded per frame
+ *
+ * Results are written as JSON (stdout or --output) for tracking regressions
+ * between releases. Runs on the offscreen platform unless QT_QPA_PLATFORM is set.
+ */
+
+#include "qtticker.h"
+#include "renderbackend.h"
+#include "tickerengine.h"
+#include "framemetrics.h"
+#include "glyphatlas.h"
+#include "composite.h"
+#include "stringimagecreater.h"
+#include "shapedtextcache.h"
+#include "scenerecorder.h"
+#include "symbolboard.h"
+#include "uploadmanager.h"
+
+#include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QColor>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFontMetrics>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QThread>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct Options
+{
+    int maxIterations;
+    double minSeconds;
+    qint64 maxImageBytes;
+    QList<int> lengths;
+    QList<int> pixelSizes;
+    QStringList fonts;
+    QStringList scripts;
+    QStringList backends;
+};
+
+QList<int> toIntList(const QString &value)
+{
+    QList<int> list;
+    for (const QString &item : value.split(',', QString::SkipEmptyParts)) {
+        list << item.toInt();
+    }
+    return list;
+}
+
+QString sampleText(const QString &script, const int length)
+{
+    static const QString latin = "The quick brown fox jumps over the lazy dog 0123456789. ";
+    static const QString cjk = QString::fromUtf8(
+        "東京株式市場で日経平均株価は続伸し、前日比百二十三円高で取引を終えた。");
+    static const QString mixed = QString::fromUtf8(
+        "NIKKEI 225 日経平均 +1.25% TOPIX 東証株価指数 -0.40% 上海総合 3,021.5 ");
+
+    const QString &unit = (script == "cjk") ? cjk : (script == "mixed") ? mixed : latin;
+    QString text;
+    text.reserve(length + unit.size());
+    while (text.size() < length) {
+        text += unit;
+    }
+    text.truncate(length);
+    return text;
+}
+
+/* repeats body until minSeconds have passed or maxIterations ran, after one warm-up run */
+QJsonObject measure(const Options &options, const std::function<void()> &body)
+{
+    body();
+
+    LatencyHistogram histogram;
+    double sum = 0.0;
+    QElapsedTimer total;
+    total.start();
+    while (histogram.count() < quint64(options.maxIterations)
+           && (histogram.count() < 3 || total.nsecsElapsed() < options.minSeconds * 1e9)) {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        const qint64 elapsed = timer.nsecsElapsed();
+        histogram.record(elapsed);
+        sum += elapsed;
+    }
+
+    QJsonObject result;
+    result.insert("iterations", double(histogram.count()));
+    result.insert("meanMs", sum / histogram.count() / 1e6);
+    result.insert("p50Ms", histogram.quantile(0.5) / 1e6);
+    result.insert("p99Ms", histogram.quantile(0.99) / 1e6);
+    result.insert("maxMs", histogram.max() / 1e6);
+    return result;
+}
+
+QJsonArray benchGenerate(const Options &options)
+{
+    QJsonArray results;
+    /* "atlas" shapes the text every time, "atlas-cached" reuses the shaped text cache */
+    for (const QString &path : { QString("painter"), QString("atlas"), QString("atlas-cached") }) {
+        const bool useAtlas = (path != "painter");
+        const bool cached = (path == "atlas-cached");
+        for (const QString &family : options.fonts) {
+            for (const int pixelSize : options.pixelSizes) {
+                GlyphAtlas atlas;
+                QFont font(family);
+                font.setPixelSize(pixelSize);
+                const int height = pixelSize * 5 / 2;
+
+                for (const QString &script : options.scripts) {
+                    for (const int length : options.lengths) {
+                        const QString text = sampleText(script, length);
+                        const int width = QFontMetrics(font).boundingRect(text).width() + 1;
+
+                        QJsonObject result;
+                        result.insert("name", "generate");
+                        result.insert("path", path);
+                        result.insert("font", family);
+                        result.insert("pixelSize", pixelSize);
+                        result.insert("script", script);
+                        result.insert("length", length);
+                        result.insert("width", width);
+                        result.insert("height", height);
+
+                        /* one image per message does not scale; report instead of swapping */
+                        if (qint64(width) * height * 4 > options.maxImageBytes) {
+                            result.insert("skipped", "image larger than --max-image-bytes");
+                            results.append(result);
+                            continue;
+                        }
+
+                        StringImageCreater creater;
+                        creater.setText(text);
+                        creater.setImageWidth(width);
+                        creater.setImageHeight(height);
+                        creater.setFont(font);
+                        creater.setFontSize(pixelSize);
+                        if (useAtlas) {
+                            creater.setGlyphAtlas(&atlas);
+                        }
+
+                        ShapedTextCache *shapedText = ShapedTextCache::global();
+                        shapedText->clear();
+                        const QJsonObject timing = measure(options, [&creater, shapedText, cached]() {
+                            if (!cached) {
+                                shapedText->clear();
+                            }
+                            creater.generate();
+                        });
+                        for (QJsonObject::const_iterator it = timing.constBegin(); it != timing.constEnd(); ++it) {
+                            result.insert(it.key(), it.value());
+                        }
+                        results.append(result);
+                    }
+                }
+            }
+        }
+    }
+    return results;
+}
+
+QJsonObject stageSummaries(FrameMetrics *metrics)
+{
+    QJsonObject stages;
+    for (int i = 0; i < FrameMetrics::StageCount; ++i) {
+        const FrameMetrics::StageSummary summary = metrics->summary(FrameMetrics::Stage(i));
+        QJsonObject stage;
+        stage.insert("p50Ms", summary.p50 / 1e6);
+        stage.insert("p99Ms", summary.p99 / 1e6);
+        stage.insert("maxMs", summary.max / 1e6);
+        stages.insert(FrameMetrics::stageName(FrameMetrics::Stage(i)), stage);
+    }
+    return stages;
+}
+
+QJsonArray benchComposite(const Options &options)
+{
+    /* one 4K strip worth of pixels, with every alpha class represented */
+    const int count = 3840 * 180;
+    quint32 seed = 4242;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed;
+    };
+
+    std::vector<quint32> source(count);
+    std::vector<quint32> background(count);
+    std::vector<uchar> mask(count);
+    for (int i = 0; i < count; ++i) {
+        const quint32 r = nextRandom();
+        const quint32 alpha = (r % 4 == 0) ? 255 : (r % 4 == 1) ? 0 : (r >> 24);
+        quint32 pixel = alpha << 24;
+        for (int c = 0; c < 3; ++c) {
+            pixel |= (alpha ? nextRandom() % (alpha + 1) : 0) << (8 * c);
+        }
+        source[i] = pixel;
+        background[i] = nextRandom() | 0xff000000;
+        mask[i] = uchar((r % 3 == 0) ? 0 : (r % 3 == 1) ? 255 : (nextRandom() >> 24));
+    }
+    const quint32 color = qPremultiply(qRgba(220, 40, 40, 200));
+
+    /* reference results */
+    const CompositeKernels &reference = Composite::scalar();
+    std::vector<quint32> expectedOver = background;
+    reference.sourceOver(expectedOver.data(), source.data(), count);
+    std::vector<quint32> expectedMask = background;
+    reference.maskOver(expectedMask.data(), mask.data(), color, count);
+
+    QJsonArray results;
+    for (const CompositeKernels *kernels : Composite::available()) {
+        std::vector<quint32> target = background;
+        kernels->sourceOver(target.data(), source.data(), count);
+        const bool overMatches = (target == expectedOver);
+        target = background;
+        kernels->maskOver(target.data(), mask.data(), color, count);
+        const bool maskMatches = (target == expectedMask);
+
+        struct Case { const char *name; std::function<void()> body; bool matches; };
+        const Case cases[] = {
+            { "sourceOver", [&]() { kernels->sourceOver(target.data(), source.data(), count); }, overMatches },
+            { "fill", [&]() { kernels->fill(target.data(), color, count); }, true },
+            { "maskOver", [&]() { kernels->maskOver(target.data(), mask.data(), color, count); }, maskMatches },
+        };
+        for (const Case &c : cases) {
+            QJsonObject result = measure(options, c.body);
+            result.insert("name", "composite");
+            result.insert("kernels", kernels->name);
+            result.insert("operation", c.name);
+            result.insert("pixels", count);
+            result.insert("mpixPerSecond", count / (result.value("meanMs").toDouble() * 1e3));
+            result.insert("matchesScalar", c.matches);
+            result.insert("selected", kernels == &Composite::kernels());
+            results.append(result);
+        }
+    }
+    return results;
+}
+
+struct StripSize
+{
+    const char *name;
+    QSize size;
+};
+
+QJsonObject benchFrame(const Options &options, const QString &backendName, const StripSize &strip,
+                       const bool scrollBlit, const QString &content)
+{
+    QtTicker ticker(backendName);
+    ticker.setStripSize(strip.size);
+    ticker.setScrollBlit(scrollBlit);
+    ticker.setMessage(sampleText("mixed", 4000));
+    /* a full strip width every 8 seconds keeps new tiles coming */
+    ticker.setScrollSpeed(strip.size.width() / 8.0);
+    ticker.show();
+    QCoreApplication::processEvents();
+
+    /* deterministic feed: 500 symbols, 20 updates per frame */
+    quint32 seed = 12345;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) & 0x7fff;
+    };
+    auto pushUpdates = [&](const int count) {
+        for (int i = 0; i < count; ++i) {
+            const int key = (count == 500) ? i : int(nextRandom() % 500);
+            const int change = int(nextRandom() % 2001) - 1000;
+            ticker.feed()->push(QString("SYM%1 %2.%3 %4%5")
+                .arg(key, 3, 10, QChar('0'))
+                .arg(100 + nextRandom() % 900).arg(nextRandom() % 100, 2, 10, QChar('0'))
+                .arg(change < 0 ? "-" : "+").arg(qAbs(change) / 100.0, 0, 'f', 2).toUtf8());
+        }
+    };
+    const bool board = (content == "board");
+    if (board) {
+        pushUpdates(500);
+    }
+
+    TickerEngine *engine = ticker.engine();
+    int frame = 0;
+    const QJsonObject timing = measure(options, [&]() {
+        if (board) {
+            pushUpdates(20);
+        }
+        engine->renderFrame(frame++ / 60.0);
+    });
+
+    QJsonObject result;
+    result.insert("name", "frame");
+    result.insert("backend", backendName);
+    result.insert("strip", strip.name);
+    result.insert("width", strip.size.width());
+    result.insert("height", strip.size.height());
+    result.insert("content", content);
+    result.insert("mode", scrollBlit ? "scroll-blit" : "full");
+    for (QJsonObject::const_iterator it = timing.constBegin(); it != timing.constEnd(); ++it) {
+        result.insert(it.key(), it.value());
+    }
+    result.insert("stages", stageSummaries(engine->frameMetrics()));
+    return result;
+}
+
+QJsonArray benchFrames(const Options &options)
+{
+    const StripSize sizes[] = { { "1080p", QSize(1920, 90) }, { "4k", QSize(3840, 180) } };
+
+    QJsonArray results;
+    for (const QString &backendName : options.backends) {
+        for (const StripSize &strip : sizes) {
+            for (const bool scrollBlit : { false, true }) {
+                for (const QString &content : { QString("message"), QString("board") }) {
+                    results.append(benchFrame(options, backendName, strip, scrollBlit, content));
+                }
+            }
+        }
+    }
+    return results;
+}
+
+QJsonObject benchOutput(const Options &options, const QString &backendName, const int outputs, const bool parallel)
+{
+    TickerEngine engine;
+    engine.setParallelOutputs(parallel);
+    engine.lanes()->lane(0)->setMessage(sampleText("mixed", 4000));
+    engine.lanes()->lane(0)->setSpeed(1920 / 8.0);
+
+    QList<QtTicker *> windows;
+    for (int i = 0; i < outputs; ++i) {
+        QtTicker *window = new QtTicker(backendName, &engine);
+        window->setScrollBlit(true);
+        window->show();
+        windows.append(window);
+    }
+    QCoreApplication::processEvents();
+
+    int frame = 0;
+    const QJsonObject timing = measure(options, [&]() {
+        engine.renderFrame(frame++ / 60.0);
+    });
+
+    QJsonObject result;
+    result.insert("name", "outputs");
+    result.insert("backend", backendName);
+    result.insert("outputs", outputs);
+    result.insert("parallel", parallel);
+    for (QJsonObject::const_iterator it = timing.constBegin(); it != timing.constEnd(); ++it) {
+        result.insert(it.key(), it.value());
+    }
+    result.insert("stripCacheBytes", double(engine.lanes()->byteSize()));
+    result.insert("stages", stageSummaries(engine.frameMetrics()));
+    qDeleteAll(windows);
+    return result;
+}
+
+QJsonArray benchOutputs(const Options &options)
+{
+    QJsonArray results;
+    for (const QString &backendName : options.backends) {
+        for (const int outputs : { 1, 2, 4, 8 }) {
+            for (const bool parallel : { false, true }) {
+                results.append(benchOutput(options, backendName, outputs, parallel));
+            }
+        }
+    }
+    return results;
+}
+
+/* counts what reaches an output without drawing it */
+class NullTarget : public SceneTarget
+{
+public:
+    NullTarget() : items(0) {}
+
+    void compose(const QImage &, const QPointF &) override { ++items; }
+    void scrollBand(const int, const int, const int) override {}
+
+    quint64 items;
+};
+
+QJsonObject benchBoard(const Options &options, const int items)
+{
+    GlyphAtlas atlas;
+    SymbolBoard board(&atlas);
+    QFont font("Sans Serif");
+    font.setPixelSize(36);
+    board.setFont(font, 90);
+    for (int i = 0; i < items; ++i) {
+        board.update(QString("SYM%1").arg(i), QString("%1.00 +0.%2").arg(100 + i % 900).arg(i % 10));
+    }
+
+    /* the crawl moves on and 1% of the quotes change every frame, some of them width */
+    SceneRecorder scene;
+    NullTarget target;
+    const double width = board.width();
+    int frame = 0;
+    const QJsonObject timing = measure(options, [&]() {
+        for (int n = 0; n < qMax(1, items / 100); ++n) {
+            const int i = (frame * 7919 + n * 104729) % items;
+            board.update(QString("SYM%1").arg(i), QString("%1.%2 -%3.5").arg(100 + frame % 9000).arg(frame % 100).arg(n % 10));
+        }
+        const double x = -std::fmod(frame * 4.0, width);
+        scene.clear();
+        board.compose(&scene, QPointF(x, 0), 1920);
+        scene.replay(&target, QRect(0, 0, 1920, 90));
+        ++frame;
+    });
+
+    QJsonObject result;
+    result.insert("name", "board");
+    result.insert("items", items);
+    for (QJsonObject::const_iterator it = timing.constBegin(); it != timing.constEnd(); ++it) {
+        result.insert(it.key(), it.value());
+    }
+    result.insert("residentItems", board.residentItems());
+    result.insert("composedPerFrame", frame > 0 ? double(target.items) / frame : 0.0);
+    return result;
+}
+
+QJsonObject benchUpload(const Options &options, const QString &backendName, const QString &content)
+{
+    QtTicker ticker(backendName);
+    ticker.setStripSize(QSize(1920, 90));
+    ticker.setUploads(true);
+    ticker.setMessage(sampleText("mixed", 4000));
+    ticker.setScrollSpeed(1920 / 8.0);
+    ticker.show();
+    QCoreApplication::processEvents();
+
+    /* every quote once, then 20 changes per frame */
+    const bool board = (content == "board");
+    int quote = 0;
+    auto pushUpdates = [&](const int count) {
+        for (int i = 0; i < count; ++i, ++quote) {
+            ticker.feed()->push(QString("SYM%1 %2.%3").arg(quote % 500, 3, 10, QChar('0'))
+                .arg(100 + quote % 900).arg(quote % 100, 2, 10, QChar('0')).toUtf8());
+        }
+    };
+    if (board) {
+        pushUpdates(500);
+    }
+
+    TickerEngine *engine = ticker.engine();
+    int frame = 0;
+    const QJsonObject timing = measure(options, [&]() {
+        if (board) {
+            pushUpdates(20);
+        }
+        engine->renderFrame(frame++ / 60.0);
+    });
+
+    QJsonObject result;
+    result.insert("name", "uploads");
+    result.insert("backend", backendName);
+    result.insert("content", content);
+    for (QJsonObject::const_iterator it = timing.constBegin(); it != timing.constEnd(); ++it) {
+        result.insert(it.key(), it.value());
+    }
+    UploadManager::Stats stats;
+    UploadManager::Format format;
+    if (ticker.backend()->uploadStats(&stats, &format)) {
+        result.insert("format", UploadManager::formatName(format));
+        result.insert("bytesPerFrame", stats.frames > 0 ? double(stats.bytes) / stats.frames : 0.0);
+        result.insert("peakFrameBytes", double(stats.peakFrameBytes));
+        result.insert("uploads", double(stats.uploads));
+        result.insert("rowsSkipped", double(stats.rowsSkipped));
+        result.insert("textures", stats.textures);
+    }
+    return result;
+}
+
+QJsonArray benchUploads(const Options &options)
+{
+    QJsonArray results;
+    for (const QString &backendName : options.backends) {
+        for (const QString &content : { QString("message"), QString("board") }) {
+            results.append(benchUpload(options, backendName, content));
+        }
+    }
+    return results;
+}
+
+QJsonArray benchBoards(const Options &options)
+{
+    QJsonArray results;
+    for (const int items : { 1000, 10000, 100000 }) {
+        results.append(benchBoard(options, items));
+    }
+    return results;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption suiteOption("suite", "Suites to run (generate, frame, composite, outputs, board, uploads).",
+                                   "list", "generate,frame,composite,outputs,board,uploads");
+    parser.addOption(suiteOption);
+    QCommandLineOption lengthsOption("lengths", "Message lengths for generate.", "list", "10,100,1000,10000,100000");
+    parser.addOption(lengthsOption);
+    QCommandLineOption sizesOption("pixel-sizes", "Font pixel sizes for generate.", "list", "24,36,72");
+    parser.addOption(sizesOption);
+    QCommandLineOption fontsOption("fonts", "Font families for generate.", "list", "Sans Serif,Serif,Monospace");
+    parser.addOption(fontsOption);
+    QCommandLineOption scriptsOption("scripts", "Scripts for generate (latin, cjk, mixed).", "list", "latin,cjk,mixed");
+    parser.addOption(scriptsOption);
+    QCommandLineOption backendsOption(
+        "backends"
+        , QString("Render backends for frame (%1).").arg(RenderBackend::availableNames().join(", "))
+        , "list", RenderBackend::availableNames().join(","));
+    parser.addOption(backendsOption);
+    QCommandLineOption iterationsOption("iterations", "Maximum iterations per case.", "n", "600");
+    parser.addOption(iterationsOption);
+    QCommandLineOption secondsOption("min-seconds", "Minimum time per case.", "s", "0.5");
+    parser.addOption(secondsOption);
+    QCommandLineOption maxBytesOption(
+        "max-image-bytes", "Skip generate cases whose image would be larger.", "bytes", "1073741824");
+    parser.addOption(maxBytesOption);
+    QCommandLineOption outputOption("output", "Write JSON to a file instead of stdout.", "path");
+    parser.addOption(outputOption);
+    parser.process(a);
+
+    Options options;
+    options.maxIterations = qMax(1, parser.value(iterationsOption).toInt());
+    options.minSeconds = parser.value(secondsOption).toDouble();
+    options.maxImageBytes = parser.value(maxBytesOption).toLongLong();
+    options.lengths = toIntList(parser.value(lengthsOption));
+    options.pixelSizes = toIntList(parser.value(sizesOption));
+    options.fonts = parser.value(fontsOption).split(',', QString::SkipEmptyParts);
+    options.scripts = parser.value(scriptsOption).split(',', QString::SkipEmptyParts);
+    options.backends = parser.value(backendsOption).split(',', QString::SkipEmptyParts);
+
+    const QStringList suites = parser.value(suiteOption).split(',', QString::SkipEmptyParts);
+    QJsonArray results;
+    if (suites.contains("generate")) {
+        for (const QJsonValue &value : benchGenerate(options)) {
+            results.append(value);
+        }
+    }
+    if (suites.contains("composite")) {
+        for (const QJsonValue &value : benchComposite(options)) {
+            results.append(value);
+        }
+    }
+    if (suites.contains("frame")) {
+        for (const QJsonValue &value : benchFrames(options)) {
+            results.append(value);
+        }
+    }
+    if (suites.contains("outputs")) {
+        for (const QJsonValue &value : benchOutputs(options)) {
+            results.append(value);
+        }
+    }
+    if (suites.contains("board")) {
+        for (const QJsonValue &value : benchBoards(options)) {
+            results.append(value);
+        }
+    }
+    if (suites.contains("uploads")) {
+        for (const QJsonValue &value : benchUploads(options)) {
+            results.append(value);
+        }
+    }
+
+    QJsonObject root;
+    root.insert("benchmark", "tickerbench");
+    root.insert("timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("qtVersion", QString(qVersion()));
+    root.insert("platform", QSysInfo::prettyProductName());
+    root.insert("cpu", QSysInfo::currentCpuArchitecture());
+    root.insert("threads", QThread::idealThreadCount());
+    root.insert("results", results);
+    const QByteArray json = QJsonDocument(root).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "cannot write " << parser.value(outputOption) << "\n";
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
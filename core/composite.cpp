@@ -0,0 +1,158 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "composite.h"
+
+#include <QDebug>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+/* multiply every channel of a premultiplied pixel by a / 255 */
+inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+
+    return x | t;
+}
+
+void sourceOverScalar(quint32 *dst, const quint32 *src, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const quint32 s = src[i];
+        const quint32 alpha = s >> 24;
+        if (alpha == 255) {
+            dst[i] = s;
+        } else if (s != 0) {
+            dst[i] = s + byteMul(dst[i], 255 - alpha);
+        }
+    }
+}
+
+void fillScalar(quint32 *dst, quint32 color, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        dst[i] = color;
+    }
+}
+
+void maskOverScalar(quint32 *dst, const uchar *mask, quint32 color, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const quint32 coverage = mask[i];
+        if (coverage == 0) {
+            continue;
+        }
+        const quint32 s = (coverage == 255) ? color : byteMul(color, coverage);
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+const CompositeKernels scalarKernels = { "scalar", sourceOverScalar, fillScalar, maskOverScalar };
+
+bool cpuHasAvx2()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    /* the OS has to save the YMM registers too */
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+    return true;
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER) && defined(_M_IX86)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return false;
+#endif
+}
+
+}
+
+const CompositeKernels &Composite::kernels()
+{
+    static const CompositeKernels *selected = detect();
+    return *selected;
+}
+
+const CompositeKernels &Composite::scalar()
+{
+    return scalarKernels;
+}
+
+QVector<const CompositeKernels *> Composite::available()
+{
+    QVector<const CompositeKernels *> sets;
+    if (compositeAvx2Kernels() != nullptr && cpuHasAvx2()) {
+        sets << compositeAvx2Kernels();
+    }
+    if (compositeSse2Kernels() != nullptr && cpuHasSse2()) {
+        sets << compositeSse2Kernels();
+    }
+    if (compositeNeonKernels() != nullptr) {
+        sets << compositeNeonKernels();
+    }
+    sets << &scalarKernels;
+    return sets;
+}
+
+QStringList Composite::availableNames()
+{
+    QStringList names;
+    for (const CompositeKernels *set : available()) {
+        names << set->name;
+    }
+    return names;
+}
+
+const CompositeKernels *Composite::detect()
+{
+    const QVector<const CompositeKernels *> sets = available();
+
+    const QByteArray forced = qgetenv("QTTICKER_COMPOSITE");
+    if (!forced.isEmpty()) {
+        for (const CompositeKernels *set : sets) {
+            if (forced == set->name) {
+                return set;
+            }
+        }
+        qWarning() << "[Composite::detect] - kernels" << forced << "not available, using" << sets.first()->name;
+    }
+    return sets.first();
+}
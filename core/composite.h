@@ -0,0 +1,54 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef COMPOSITE_H
+#define COMPOSITE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Span kernels for ARGB32 premultiplied pixels. Every implementation is
+ * bit-exact with the scalar reference, which uses the same rounding as
+ * Qt's BYTE_MUL: c * a / 255 as (t + (t >> 8) + 0x80) >> 8 with t = c * a.
+ *
+ *   sourceOver  dst = src + dst * (255 - alpha(src)) / 255
+ *   fill        dst = color
+ *   maskOver    source-over of color * mask / 255, for glyph coverage masks
+ */
+struct CompositeKernels
+{
+    const char *name;
+    void (*sourceOver)(quint32 *dst, const quint32 *src, int count);
+    void (*fill)(quint32 *dst, quint32 color, int count);
+    void (*maskOver)(quint32 *dst, const uchar *mask, quint32 color, int count);
+};
+
+/*
+ * Picks the widest kernel set the CPU supports at run time (AVX2, SSE2,
+ * NEON, scalar). QTTICKER_COMPOSITE=<name> overrides the choice.
+ */
+class Composite
+{
+public:
+    static const CompositeKernels &kernels();
+    static const CompositeKernels &scalar();
+
+    /* every kernel set this build has and this CPU can run, widest first */
+    static QVector<const CompositeKernels *> available();
+    static QStringList availableNames();
+
+private:
+    static const CompositeKernels *detect();
+};
+
+/* implemented per instruction set; null when not built for this target */
+const CompositeKernels *compositeAvx2Kernels();
+const CompositeKernels *compositeSse2Kernels();
+const CompositeKernels *compositeNeonKernels();
+
+#endif
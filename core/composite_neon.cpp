@@ -0,0 +1,119 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "composite.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+#include <string.h>
+
+namespace
+{
+
+inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+
+    return x | t;
+}
+
+/*
+ * 4 pixels per step. vraddhn(t, t >> 8) is exactly (t + (t >> 8) + 0x80) >> 8
+ * narrowed to 8 bits, the scalar byteMul rounding; the final add is 32-bit.
+ */
+
+/* every byte multiplied by the matching byte of factors */
+inline uint8x16_t byteMulNeon(uint8x16_t pixels, uint8x16_t factors)
+{
+    const uint16x8_t lo = vmull_u8(vget_low_u8(pixels), vget_low_u8(factors));
+    const uint16x8_t hi = vmull_u8(vget_high_u8(pixels), vget_high_u8(factors));
+    return vcombine_u8(vraddhn_u16(lo, vshrq_n_u16(lo, 8)), vraddhn_u16(hi, vshrq_n_u16(hi, 8)));
+}
+
+/* 32-bit lanes holding 0..255 -> the value in every byte of the lane */
+inline uint8x16_t spreadNeon(uint32x4_t factor)
+{
+    return vreinterpretq_u8_u32(vmulq_n_u32(factor, 0x01010101u));
+}
+
+inline uint32x4_t overNeon(uint32x4_t s, uint32x4_t d)
+{
+    const uint8x16_t inverse = vmvnq_u8(spreadNeon(vshrq_n_u32(s, 24)));
+    return vaddq_u32(s, vreinterpretq_u32_u8(byteMulNeon(vreinterpretq_u8_u32(d), inverse)));
+}
+
+void sourceOverNeon(quint32 *dst, const quint32 *src, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t s = vld1q_u32(src + i);
+        const uint32x4_t d = vld1q_u32(dst + i);
+        vst1q_u32(dst + i, overNeon(s, d));
+    }
+    for (; i < count; ++i) {
+        const quint32 s = src[i];
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+void fillNeon(quint32 *dst, quint32 color, int count)
+{
+    const uint32x4_t value = vdupq_n_u32(color);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(dst + i, value);
+    }
+    for (; i < count; ++i) {
+        dst[i] = color;
+    }
+}
+
+void maskOverNeon(quint32 *dst, const uchar *mask, quint32 color, int count)
+{
+    const uint8x16_t colors = vreinterpretq_u8_u32(vdupq_n_u32(color));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        quint32 coverage4;
+        memcpy(&coverage4, mask + i, 4);
+        if (coverage4 == 0) {
+            continue;
+        }
+        const uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(coverage4));
+        const uint32x4_t coverage = vmovl_u16(vget_low_u16(vmovl_u8(bytes)));
+        const uint32x4_t s = vreinterpretq_u32_u8(byteMulNeon(colors, spreadNeon(coverage)));
+        vst1q_u32(dst + i, overNeon(s, vld1q_u32(dst + i)));
+    }
+    for (; i < count; ++i) {
+        const quint32 s = byteMul(color, mask[i]);
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+const CompositeKernels neonKernels = { "neon", sourceOverNeon, fillNeon, maskOverNeon };
+
+}
+
+const CompositeKernels *compositeNeonKernels()
+{
+    return &neonKernels;
+}
+
+#else
+
+const CompositeKernels *compositeNeonKernels()
+{
+    return nullptr;
+}
+
+#endif
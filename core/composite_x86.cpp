@@ -0,0 +1,262 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "composite.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define COMPOSITE_X86
+#endif
+
+#ifdef COMPOSITE_X86
+
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <string.h>
+
+/* the AVX2 kernels are built for AVX2 alone and only run when the CPU has it */
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+
+/* scalar tails, identical to the reference */
+inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+
+    return x | t;
+}
+
+inline void sourceOverTail(quint32 *dst, const quint32 *src, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const quint32 s = src[i];
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+inline void maskOverTail(quint32 *dst, const uchar *mask, quint32 color, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const quint32 s = byteMul(color, mask[i]);
+        dst[i] = s + byteMul(dst[i], 255 - (s >> 24));
+    }
+}
+
+/*
+ * SSE2, 4 pixels per step. Channels are widened to 16 bits, where
+ * (t + (t >> 8) + 0x80) >> 8 cannot overflow, so the result matches the
+ * scalar byteMul bit for bit. The final add is 32-bit like the scalar one.
+ */
+
+/* 32-bit lanes holding a factor 0..255 -> the factor in all four 16-bit channels of each pixel */
+TARGET_SSE2 inline void spreadSse2(__m128i factor, __m128i *lo, __m128i *hi)
+{
+    factor = _mm_or_si128(factor, _mm_slli_epi32(factor, 16));
+    *lo = _mm_unpacklo_epi32(factor, factor);
+    *hi = _mm_unpackhi_epi32(factor, factor);
+}
+
+TARGET_SSE2 inline __m128i byteMulSse2(__m128i pixels, __m128i factorLo, __m128i factorHi)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(0x80);
+
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), factorLo);
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), factorHi);
+    lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), half), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), half), 8);
+    return _mm_packus_epi16(lo, hi);
+}
+
+TARGET_SSE2 inline __m128i overSse2(__m128i s, __m128i d)
+{
+    const __m128i inverse = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(s, 24));
+    __m128i lo, hi;
+    spreadSse2(inverse, &lo, &hi);
+    return _mm_add_epi32(s, byteMulSse2(d, lo, hi));
+}
+
+TARGET_SSE2 void sourceOverSse2(quint32 *dst, const quint32 *src, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(int(0xff000000));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i alpha = _mm_and_si128(s, opaque);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xffff) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xffff) {
+            continue;
+        }
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), overSse2(s, d));
+    }
+    sourceOverTail(dst + i, src + i, count - i);
+}
+
+TARGET_SSE2 void fillSse2(quint32 *dst, quint32 color, int count)
+{
+    const __m128i value = _mm_set1_epi32(int(color));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), value);
+    }
+    for (; i < count; ++i) {
+        dst[i] = color;
+    }
+}
+
+TARGET_SSE2 void maskOverSse2(quint32 *dst, const uchar *mask, quint32 color, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colors = _mm_set1_epi32(int(color));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        quint32 coverage4;
+        memcpy(&coverage4, mask + i, 4);
+        if (coverage4 == 0) {
+            continue;
+        }
+        const __m128i coverage = _mm_unpacklo_epi16(
+            _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(coverage4)), zero), zero);
+        __m128i lo, hi;
+        spreadSse2(coverage, &lo, &hi);
+        const __m128i s = byteMulSse2(colors, lo, hi);
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), overSse2(s, d));
+    }
+    maskOverTail(dst + i, mask + i, color, count - i);
+}
+
+/* AVX2, 8 pixels per step; the unpacks work per 128-bit half, so the packs restore the order */
+
+TARGET_AVX2 inline void spreadAvx2(__m256i factor, __m256i *lo, __m256i *hi)
+{
+    factor = _mm256_or_si256(factor, _mm256_slli_epi32(factor, 16));
+    *lo = _mm256_unpacklo_epi32(factor, factor);
+    *hi = _mm256_unpackhi_epi32(factor, factor);
+}
+
+TARGET_AVX2 inline __m256i byteMulAvx2(__m256i pixels, __m256i factorLo, __m256i factorHi)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(0x80);
+
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), factorLo);
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), factorHi);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), half), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), half), 8);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+TARGET_AVX2 inline __m256i overAvx2(__m256i s, __m256i d)
+{
+    const __m256i inverse = _mm256_sub_epi32(_mm256_set1_epi32(255), _mm256_srli_epi32(s, 24));
+    __m256i lo, hi;
+    spreadAvx2(inverse, &lo, &hi);
+    return _mm256_add_epi32(s, byteMulAvx2(d, lo, hi));
+}
+
+TARGET_AVX2 void sourceOverAvx2(quint32 *dst, const quint32 *src, int count)
+{
+    const __m256i opaque = _mm256_set1_epi32(int(0xff000000));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const __m256i alpha = _mm256_and_si256(s, opaque);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, opaque)) == -1) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), s);
+            continue;
+        }
+        if (_mm256_testz_si256(s, s)) {
+            continue;
+        }
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), overAvx2(s, d));
+    }
+    sourceOverTail(dst + i, src + i, count - i);
+}
+
+TARGET_AVX2 void fillAvx2(quint32 *dst, quint32 color, int count)
+{
+    const __m256i value = _mm256_set1_epi32(int(color));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), value);
+    }
+    for (; i < count; ++i) {
+        dst[i] = color;
+    }
+}
+
+TARGET_AVX2 void maskOverAvx2(quint32 *dst, const uchar *mask, quint32 color, int count)
+{
+    const __m256i colors = _mm256_set1_epi32(int(color));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        quint64 coverage8;
+        memcpy(&coverage8, mask + i, 8);
+        if (coverage8 == 0) {
+            continue;
+        }
+        __m256i lo, hi;
+        spreadAvx2(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(mask + i))), &lo, &hi);
+        const __m256i s = byteMulAvx2(colors, lo, hi);
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), overAvx2(s, d));
+    }
+    maskOverTail(dst + i, mask + i, color, count - i);
+}
+
+const CompositeKernels sse2Kernels = { "sse2", sourceOverSse2, fillSse2, maskOverSse2 };
+const CompositeKernels avx2Kernels = { "avx2", sourceOverAvx2, fillAvx2, maskOverAvx2 };
+
+}
+
+const CompositeKernels *compositeSse2Kernels()
+{
+    return &sse2Kernels;
+}
+
+const CompositeKernels *compositeAvx2Kernels()
+{
+    return &avx2Kernels;
+}
+
+#else
+
+const CompositeKernels *compositeSse2Kernels()
+{
+    return nullptr;
+}
+
+const CompositeKernels *compositeAvx2Kernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "feedingest.h"
+#include "feedtransport.h"
+
+#include <QHash>
+
+FeedIngest::FeedIngest(const int capacity)
+    : mCapacity(capacity)
+    , mReceived(0)
+    , mDropped(0)
+    , mCoalesced(0)
+{
+}
+
+FeedIngest::~FeedIngest()
+{
+    stop();
+}
+
+void FeedIngest::openStdin()
+{
+    addTransport(new StreamFeedTransport(this, QString()));
+}
+
+void FeedIngest::openPipe(const QString &path)
+{
+    addTransport(new StreamFeedTransport(this, path));
+}
+
+void FeedIngest::openLocalSocket(const QString &serverName)
+{
+    addTransport(new LocalSocketFeedTransport(this, serverName));
+}
+
+void FeedIngest::stop()
+{
+    for (FeedTransport *transport : mTransports) {
+        transport->stop();
+    }
+    qDeleteAll(mTransports);
+    mTransports.clear();
+}
+
+void FeedIngest::push(const QByteArray &record)
+{
+    FeedUpdate update;
+    if (!parseRecord(record, &update)) {
+        return;
+    }
+
+    mReceived.fetchAndAddRelaxed(1);
+    if (mQueue.size() >= mCapacity) {
+        /* the frame loop fell far behind; shed load instead of growing without bound */
+        mDropped.fetchAndAddRelaxed(1);
+        return;
+    }
+    mQueue.push(std::move(update));
+    if (mNotify) {
+        mNotify();
+    }
+}
+
+QVector<FeedUpdate> FeedIngest::drain(const int maxUpdates)
+{
+    QVector<FeedUpdate> latest;
+    QHash<QString, int> index;
+
+    FeedUpdate update;
+    for (int n = 0; n < maxUpdates && mQueue.pop(update); ++n) {
+        QHash<QString, int>::const_iterator it = index.constFind(update.key);
+        if (it == index.constEnd()) {
+            index.insert(update.key, latest.size());
+            latest.append(std::move(update));
+        } else {
+            latest[it.value()] = std::move(update);
+            ++mCoalesced;
+        }
+    }
+    return latest;
+}
+
+bool FeedIngest::parseRecord(const QByteArray &record, FeedUpdate *update)
+{
+    const QByteArray line = record.trimmed();
+    if (line.isEmpty()) {
+        return false;
+    }
+
+    int split = 0;
+    while (split < line.size() && line.at(split) != ' ' && line.at(split) != '\t') {
+        ++split;
+    }
+    update->key = QString::fromUtf8(line.constData(), split);
+    update->text = QString::fromUtf8(line.mid(split).trimmed());
+    return true;
+}
+
+void FeedIngest::addTransport(FeedTransport *transport)
+{
+    mTransports.append(transport);
+    transport->start();
+}
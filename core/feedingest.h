@@ -0,0 +1,75 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef FEEDINGEST_H
+#define FEEDINGEST_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+#include "mpscqueue.h"
+
+class FeedTransport;
+
+struct FeedUpdate
+{
+    QString key;
+    QString text;
+};
+
+/*
+ * Feed records arrive from any number of transport threads as lines of
+ *   <key> <text...>
+ * are parsed on the producer side and queued lock-free. The frame loop drains
+ * the queue once per frame and gets only the latest update of every key.
+ */
+class FeedIngest
+{
+public:
+    explicit FeedIngest(const int capacity = 1 << 20);
+    ~FeedIngest();
+
+    void openStdin();
+    void openPipe(const QString &path);
+    void openLocalSocket(const QString &serverName);
+    void stop();
+
+    /* producer side, callable from any thread */
+    void push(const QByteArray &record);
+
+    /* called on the producer thread after every queued record; set before opening transports */
+    void setNotify(const std::function<void()> &notify) {
+        mNotify = notify;
+    }
+
+    /* consumer side, frame loop only */
+    QVector<FeedUpdate> drain(const int maxUpdates = 65536);
+
+    static bool parseRecord(const QByteArray &record, FeedUpdate *update);
+
+    quint64 received() const { return mReceived.load(); }
+    quint64 dropped() const { return mDropped.load(); }
+    quint64 coalesced() const { return mCoalesced; }
+    int queueDepth() const { return mQueue.size(); }
+
+private:
+    void addTransport(FeedTransport *transport);
+
+    int mCapacity;
+    MpscQueue<FeedUpdate> mQueue;
+    QList<FeedTransport *> mTransports;
+    std::function<void()> mNotify;
+
+    QAtomicInteger<quint64> mReceived;
+    QAtomicInteger<quint64> mDropped;
+    quint64 mCoalesced;
+};
+
+#endif
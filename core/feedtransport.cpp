@@ -0,0 +1,170 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "feedtransport.h"
+#include "feedingest.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+FeedTransport::FeedTransport(FeedIngest *ingest, QObject *parent)
+    : QThread(parent)
+    , mIngest(ingest)
+{
+}
+
+FeedTransport::~FeedTransport()
+{
+}
+
+void FeedTransport::stop()
+{
+    requestInterruption();
+    quit();
+    if (!wait(1000)) {
+        qWarning() << "[FeedTransport::stop] - reader did not stop, terminating";
+        terminate();
+        wait();
+    }
+}
+
+void FeedTransport::pushLines(QByteArray &buffer)
+{
+    int start = 0;
+    for (;;) {
+        const int end = buffer.indexOf('\n', start);
+        if (end < 0) {
+            break;
+        }
+        mIngest->push(QByteArray::fromRawData(buffer.constData() + start, end - start));
+        start = end + 1;
+    }
+    buffer.remove(0, start);
+}
+
+StreamFeedTransport::StreamFeedTransport(FeedIngest *ingest, const QString &path, QObject *parent)
+    : FeedTransport(ingest, parent)
+    , mPath(path)
+{
+}
+
+void StreamFeedTransport::run()
+{
+    QByteArray buffer;
+
+#ifdef Q_OS_UNIX
+    /*
+     * Poll with a timeout so stop() never waits on a blocking read.
+     * A FIFO is opened read-write so it does not hit EOF every time the
+     * last writer closes it.
+     */
+    const int fd = mPath.isEmpty()
+        ? STDIN_FILENO
+        : ::open(QFile::encodeName(mPath).constData(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        qWarning() << "[StreamFeedTransport::run] - cannot open" << mPath;
+        return;
+    }
+
+    char chunk[65536];
+    while (!isInterruptionRequested()) {
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        const int ready = ::poll(&pfd, 1, 100);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer.append(chunk, int(n));
+            pushLines(buffer);
+        } else if (n == 0) {
+            break;
+        } else if (errno != EAGAIN && errno != EINTR) {
+            break;
+        }
+    }
+
+    if (fd != STDIN_FILENO) {
+        ::close(fd);
+    }
+#else
+    QFile file(mPath);
+    const bool opened = mPath.isEmpty()
+        ? file.open(stdin, QIODevice::ReadOnly)
+        : file.open(QIODevice::ReadOnly);
+    if (!opened) {
+        qWarning() << "[StreamFeedTransport::run] - cannot open" << mPath;
+        return;
+    }
+
+    /* blocking reads; stop() falls back to terminate() if no line arrives */
+    while (!isInterruptionRequested()) {
+        buffer = file.readLine();
+        if (buffer.isEmpty()) {
+            if (file.atEnd()) {
+                break;
+            }
+            continue;
+        }
+        mIngest->push(buffer);
+    }
+    buffer.clear();
+#endif
+
+    if (!buffer.isEmpty()) {
+        mIngest->push(buffer);
+    }
+}
+
+LocalSocketFeedTransport::LocalSocketFeedTransport(FeedIngest *ingest, const QString &serverName, QObject *parent)
+    : FeedTransport(ingest, parent)
+    , mServerName(serverName)
+{
+}
+
+void LocalSocketFeedTransport::run()
+{
+    /* the server and its sockets live in this thread's event loop */
+    QLocalServer server;
+    QLocalServer::removeServer(mServerName);
+    if (!server.listen(mServerName)) {
+        qWarning() << "[LocalSocketFeedTransport::run] - cannot listen on" << mServerName
+                   << ":" << server.errorString();
+        return;
+    }
+
+    FeedIngest *ingest = mIngest;
+    connect(&server, &QLocalServer::newConnection, &server, [&server, ingest]() {
+        while (QLocalSocket *socket = server.nextPendingConnection()) {
+            connect(socket, &QLocalSocket::readyRead, socket, [socket, ingest]() {
+                while (socket->canReadLine()) {
+                    ingest->push(socket->readLine());
+                }
+            });
+            connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+
+    if (isInterruptionRequested()) {
+        return;
+    }
+    exec();
+}
@@ -0,0 +1,66 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef FEEDTRANSPORT_H
+#define FEEDTRANSPORT_H
+
+#include <QThread>
+#include <QString>
+#include <QByteArray>
+
+class FeedIngest;
+
+/*
+ * A local feed source. Every transport reads on its own thread and pushes
+ * complete lines into the FeedIngest queue.
+ */
+class FeedTransport : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit FeedTransport(FeedIngest *ingest, QObject *parent = Q_NULLPTR);
+    virtual ~FeedTransport();
+
+    void stop();
+
+protected:
+    /* split buffered bytes into lines; the incomplete tail stays in buffer */
+    void pushLines(QByteArray &buffer);
+
+    FeedIngest *mIngest;
+};
+
+/* stdin when path is empty, otherwise a named pipe (FIFO) that may be reopened by writers */
+class StreamFeedTransport : public FeedTransport
+{
+    Q_OBJECT
+
+public:
+    StreamFeedTransport(FeedIngest *ingest, const QString &path, QObject *parent = Q_NULLPTR);
+
+protected:
+    void run() override;
+
+private:
+    QString mPath;
+};
+
+/* QLocalServer: a Unix domain socket, or a named pipe on Windows */
+class LocalSocketFeedTransport : public FeedTransport
+{
+    Q_OBJECT
+
+public:
+    LocalSocketFeedTransport(FeedIngest *ingest, const QString &serverName, QObject *parent = Q_NULLPTR);
+
+protected:
+    void run() override;
+
+private:
+    QString mServerName;
+};
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "framemetrics.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtAlgorithms>
+#include <QtMath>
+
+#include <string.h>
+
+LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+
+void LatencyHistogram::record(const qint64 nsecs)
+{
+    ++mBuckets[bucket(nsecs)];
+    ++mCount;
+    mMax = qMax(mMax, nsecs);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BucketCount; ++i) {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mMax = qMax(mMax, other.mMax);
+}
+
+void LatencyHistogram::clear()
+{
+    memset(mBuckets, 0, sizeof(mBuckets));
+    mCount = 0;
+    mMax = 0;
+}
+
+qint64 LatencyHistogram::quantile(const double q) const
+{
+    if (mCount == 0) {
+        return 0;
+    }
+
+    const quint64 rank = qMax<quint64>(1, quint64(qCeil(q * mCount)));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += mBuckets[i];
+        if (seen >= rank) {
+            return qMin(upperBound(i), mMax);
+        }
+    }
+    return mMax;
+}
+
+int LatencyHistogram::bucket(const qint64 nsecs)
+{
+    const quint64 us = quint64(qMax<qint64>(0, nsecs)) / 1000;
+    if (us < 8) {
+        return int(us);
+    }
+
+    /* 8 sub-buckets per power of two */
+    const int octave = 63 - int(qCountLeadingZeroBits(us));
+    const int sub = int(us >> (octave - 3)) & 7;
+    return qMin((octave - 2) * 8 + sub, int(BucketCount) - 1);
+}
+
+qint64 LatencyHistogram::upperBound(const int bucket)
+{
+    if (bucket < 8) {
+        return qint64(bucket + 1) * 1000;
+    }
+
+    const int octave = bucket / 8 + 2;
+    const int sub = bucket % 8;
+    return (qint64(9 + sub) << (octave - 3)) * 1000;
+}
+
+FrameMetrics::FrameMetrics()
+    : mWindow(10000)
+    , mWindowStart(0)
+    , mFrames(0)
+    , mOverBudget(0)
+    , mBudget(0)
+{
+    for (int i = 0; i < StageCount; ++i) {
+        mCount[i] = 0;
+        mSum[i] = 0.0;
+    }
+    mClock.start();
+}
+
+void FrameMetrics::addFrame(const qint64 tick, const qint64 compose, const qint64 present, const qint64 budget)
+{
+    if (mClock.elapsed() - mWindowStart >= mWindow) {
+        rotate();
+    }
+
+    const qint64 durations[StageCount] = { tick, compose, present, tick + compose + present };
+    for (int i = 0; i < StageCount; ++i) {
+        mCurrent[i].record(durations[i]);
+        ++mCount[i];
+        mSum[i] += durations[i] / 1e9;
+    }
+
+    ++mFrames;
+    mBudget = budget;
+    if (durations[Frame] > budget) {
+        ++mOverBudget;
+    }
+}
+
+void FrameMetrics::setGauge(const QByteArray &name, const QByteArray &help, const double value)
+{
+    for (Gauge &gauge : mGauges) {
+        if (gauge.name == name) {
+            gauge.value = value;
+            return;
+        }
+    }
+
+    Gauge gauge;
+    gauge.name = name;
+    gauge.help = help;
+    gauge.value = value;
+    mGauges.append(gauge);
+}
+
+FrameMetrics::StageSummary FrameMetrics::summary(const Stage stage) const
+{
+    LatencyHistogram window = mPrevious[stage];
+    window.merge(mCurrent[stage]);
+
+    StageSummary summary;
+    summary.p50 = window.quantile(0.5);
+    summary.p99 = window.quantile(0.99);
+    summary.max = window.max();
+    summary.count = mCount[stage];
+    summary.sum = mSum[stage];
+    return summary;
+}
+
+QByteArray FrameMetrics::toPrometheus()
+{
+    sample();
+
+    QByteArray out;
+    out += "# HELP qtticker_stage_seconds Frame stage latency; quantiles over the recent window.\n";
+    out += "# TYPE qtticker_stage_seconds summary\n";
+    for (int i = 0; i < StageCount; ++i) {
+        const StageSummary s = summary(Stage(i));
+        const QByteArray label = QByteArray("stage=\"") + stageName(Stage(i)) + "\"";
+        out += "qtticker_stage_seconds{" + label + ",quantile=\"0.5\"} " + QByteArray::number(s.p50 / 1e9, 'g', 9) + "\n";
+        out += "qtticker_stage_seconds{" + label + ",quantile=\"0.99\"} " + QByteArray::number(s.p99 / 1e9, 'g', 9) + "\n";
+        out += "qtticker_stage_seconds_sum{" + label + "} " + QByteArray::number(s.sum, 'g', 12) + "\n";
+        out += "qtticker_stage_seconds_count{" + label + "} " + QByteArray::number(s.count) + "\n";
+    }
+
+    out += "# HELP qtticker_stage_max_seconds Slowest frame stage in the recent window.\n";
+    out += "# TYPE qtticker_stage_max_seconds gauge\n";
+    for (int i = 0; i < StageCount; ++i) {
+        out += QByteArray("qtticker_stage_max_seconds{stage=\"") + stageName(Stage(i)) + "\"} "
+            + QByteArray::number(summary(Stage(i)).max / 1e9, 'g', 9) + "\n";
+    }
+
+    out += "# HELP qtticker_frames_total Frames rendered.\n";
+    out += "# TYPE qtticker_frames_total counter\n";
+    out += "qtticker_frames_total " + QByteArray::number(mFrames) + "\n";
+    out += "# HELP qtticker_frames_over_budget_total Frames whose stages took longer than the frame period.\n";
+    out += "# TYPE qtticker_frames_over_budget_total counter\n";
+    out += "qtticker_frames_over_budget_total " + QByteArray::number(mOverBudget) + "\n";
+    out += "# HELP qtticker_frame_budget_seconds Frame period.\n";
+    out += "# TYPE qtticker_frame_budget_seconds gauge\n";
+    out += "qtticker_frame_budget_seconds " + QByteArray::number(mBudget / 1e9, 'g', 9) + "\n";
+
+    for (const Gauge &gauge : mGauges) {
+        out += "# HELP qtticker_" + gauge.name + " " + gauge.help + "\n";
+        out += "# TYPE qtticker_" + gauge.name + " gauge\n";
+        out += "qtticker_" + gauge.name + " " + QByteArray::number(gauge.value, 'g', 12) + "\n";
+    }
+    return out;
+}
+
+QByteArray FrameMetrics::toJson()
+{
+    sample();
+
+    QJsonObject stages;
+    for (int i = 0; i < StageCount; ++i) {
+        const StageSummary s = summary(Stage(i));
+        QJsonObject stage;
+        stage.insert("p50Ms", s.p50 / 1e6);
+        stage.insert("p99Ms", s.p99 / 1e6);
+        stage.insert("maxMs", s.max / 1e6);
+        stage.insert("count", double(s.count));
+        stage.insert("sumSeconds", s.sum);
+        stages.insert(stageName(Stage(i)), stage);
+    }
+
+    QJsonObject gauges;
+    for (const Gauge &gauge : mGauges) {
+        gauges.insert(QString::fromLatin1(gauge.name), gauge.value);
+    }
+
+    QJsonObject root;
+    root.insert("frames", double(mFrames));
+    root.insert("framesOverBudget", double(mOverBudget));
+    root.insert("budgetMs", mBudget / 1e6);
+    root.insert("stages", stages);
+    root.insert("gauges", gauges);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact) + "\n";
+}
+
+QString FrameMetrics::hudText()
+{
+    sample();
+
+    QString text;
+    for (int i = 0; i < StageCount; ++i) {
+        const StageSummary s = summary(Stage(i));
+        text += QString("%1 %2/%3/%4  ")
+            .arg(stageName(Stage(i)))
+            .arg(s.p50 / 1e6, 0, 'f', 2)
+            .arg(s.p99 / 1e6, 0, 'f', 2)
+            .arg(s.max / 1e6, 0, 'f', 2);
+    }
+    text += QString("ms (p50/p99/max)\nover budget %1/%2").arg(mOverBudget).arg(mFrames);
+    for (const Gauge &gauge : mGauges) {
+        text += QString("  %1 %2").arg(QString::fromLatin1(gauge.name)).arg(gauge.value, 0, 'g', 6);
+    }
+    return text;
+}
+
+const char *FrameMetrics::stageName(const Stage stage)
+{
+    switch (stage) {
+    case Tick: return "tick";
+    case Compose: return "compose";
+    case Present: return "present";
+    case Frame: return "frame";
+    default: return "unknown";
+    }
+}
+
+void FrameMetrics::rotate()
+{
+    for (int i = 0; i < StageCount; ++i) {
+        mPrevious[i] = mCurrent[i];
+        mCurrent[i].clear();
+    }
+    mWindowStart = mClock.elapsed();
+}
+
+void FrameMetrics::sample()
+{
+    if (mSampler) {
+        mSampler(*this);
+    }
+}
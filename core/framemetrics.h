@@ -0,0 +1,120 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef FRAMEMETRICS_H
+#define FRAMEMETRICS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/*
+ * Latency histogram with 8 log-spaced buckets per octave of microseconds
+ * (about 9% resolution), from 1us to about 8s. Recording is a couple of
+ * shifts and an increment, so it can stay on in production.
+ */
+class LatencyHistogram
+{
+public:
+    enum { BucketCount = 176 };
+
+    LatencyHistogram();
+
+    void record(const qint64 nsecs);
+    void merge(const LatencyHistogram &other);
+    void clear();
+
+    quint64 count() const { return mCount; }
+    qint64 max() const { return mMax; }
+
+    /* upper bound of the bucket holding the given quantile, in ns */
+    qint64 quantile(const double q) const;
+
+private:
+    static int bucket(const qint64 nsecs);
+    static qint64 upperBound(const int bucket);
+
+    quint32 mBuckets[BucketCount];
+    quint64 mCount;
+    qint64 mMax;
+};
+
+/*
+ * Per-stage frame timings plus named gauges, exported as Prometheus text or
+ * JSON. Quantiles and maxima cover a sliding window of the last one to two
+ * window lengths; counts and sums are cumulative. Owned and fed by the frame
+ * loop; not thread-safe.
+ */
+class FrameMetrics
+{
+public:
+    enum Stage { Tick, Compose, Present, Frame, StageCount };
+
+    struct StageSummary
+    {
+        qint64 p50;     // ns
+        qint64 p99;     // ns
+        qint64 max;     // ns
+        quint64 count;
+        double sum;     // seconds, cumulative
+    };
+
+    FrameMetrics();
+
+    void setWindow(const qint64 msecs) {
+        mWindow = msecs;
+    }
+
+    /* one call per frame with the duration of every stage in ns */
+    void addFrame(const qint64 tick, const qint64 compose, const qint64 present, const qint64 budget);
+
+    /* called before every export to refresh the gauges */
+    void setSampler(const std::function<void(FrameMetrics &)> &sampler) {
+        mSampler = sampler;
+    }
+    void setGauge(const QByteArray &name, const QByteArray &help, const double value);
+
+    StageSummary summary(const Stage stage) const;
+    quint64 frames() const { return mFrames; }
+    quint64 framesOverBudget() const { return mOverBudget; }
+
+    QByteArray toPrometheus();
+    QByteArray toJson();
+    QString hudText();
+
+    static const char *stageName(const Stage stage);
+
+private:
+    struct Gauge
+    {
+        QByteArray name;
+        QByteArray help;
+        double value;
+    };
+
+    void rotate();
+    void sample();
+
+    QElapsedTimer mClock;
+    qint64 mWindow;
+    qint64 mWindowStart;
+
+    LatencyHistogram mCurrent[StageCount];
+    LatencyHistogram mPrevious[StageCount];
+    quint64 mCount[StageCount];
+    double mSum[StageCount];
+
+    quint64 mFrames;
+    quint64 mOverBudget;
+    qint64 mBudget;
+
+    std::function<void(FrameMetrics &)> mSampler;
+    QVector<Gauge> mGauges;
+};
+
+#endif
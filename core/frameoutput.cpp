@@ -0,0 +1,481 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "frameoutput.h"
+#include "rasterrenderwidget.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QtMath>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FrameOutput::FrameOutput()
+    : mOverruns(0)
+    , mFps(60.0)
+    , mOpen(false)
+    , mHasFrame(false)
+    , mLastIndex(0)
+    , mFrames(0)
+    , mDropped(0)
+    , mDuplicated(0)
+{
+}
+
+FrameOutput::~FrameOutput()
+{
+}
+
+FrameOutput *FrameOutput::create(const QString &spec)
+{
+    const QString kind = spec.section(':', 0, 0);
+    const QStringList fields = spec.section(':', 1).split(',', QString::SkipEmptyParts);
+    const QString target = fields.value(0);
+
+    if (kind == "pipe" && !target.isEmpty()) {
+        return new PipeFrameOutput(target);
+    }
+#ifdef Q_OS_UNIX
+    if (kind == "shm" && target.startsWith('/')) {
+        int slots = 4;
+        for (const QString &field : fields.mid(1)) {
+            if (field.startsWith("slots=")) {
+                slots = qBound(2, field.mid(6).toInt(), 64);
+            }
+        }
+        return new ShmFrameOutput(target, slots);
+    }
+#endif
+
+    qWarning() << "[FrameOutput::create] - Unsupported frame output" << spec;
+    return nullptr;
+}
+
+void FrameOutput::setFrameRate(const double fps)
+{
+    /* takes effect on the next (re)open, the cadence is part of the stream */
+    mFps = qMax(1.0, fps);
+}
+
+void FrameOutput::submit(const RasterRenderWidget *source, const double sceneTime)
+{
+    const QSize size = source->frameSize();
+    if (size.isEmpty()) {
+        return;
+    }
+
+    /* a new size starts a new stream */
+    if (!mOpen || size != mSize) {
+        close();
+        mSize = size;
+        mOpen = openSink(mSize, mSize.width() * 4, mFps);
+    }
+    if (!mOpen) {
+        mDropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    const qint64 index = qFloor(sceneTime * mFps + 0.5);
+    if (mHasFrame && index <= mLastIndex) {
+        /* rendered faster than the output rate; this slot already went out */
+        mDropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    /* slots the render loop missed repeat the last frame, those the sink cannot repeat are dropped */
+    const qint64 missing = mHasFrame ? index - mLastIndex - 1 : 0;
+    if (missing > 0) {
+        const qint64 repeated = repeatFrame(quint64(mLastIndex + 1), missing);
+        mDuplicated.fetchAndAddRelaxed(quint64(repeated));
+        mDropped.fetchAndAddRelaxed(quint64(missing - repeated));
+    }
+    mLastIndex = index;
+
+    uchar *bits = beginFrame();
+    if (bits == nullptr) {
+        mDropped.fetchAndAddRelaxed(1);
+        return;
+    }
+    source->readFrame(bits, mSize.width() * 4);
+    publishFrame(quint64(index), timestamp(quint64(index)));
+    mFrames.fetchAndAddRelaxed(1);
+    mHasFrame = true;
+}
+
+void FrameOutput::close()
+{
+    if (mOpen) {
+        closeSink();
+    }
+    mOpen = false;
+    mHasFrame = false;
+}
+
+FrameOutput::Stats FrameOutput::stats() const
+{
+    Stats stats;
+    stats.frames = mFrames.load();
+    stats.dropped = mDropped.load();
+    stats.duplicated = mDuplicated.load();
+    stats.overruns = mOverruns.load();
+    return stats;
+}
+
+QString FrameOutput::report() const
+{
+    const Stats s = stats();
+    return QString("frames %1, dropped %2, duplicated %3, reader overruns %4")
+        .arg(s.frames).arg(s.dropped).arg(s.duplicated).arg(s.overruns);
+}
+
+#ifdef Q_OS_UNIX
+
+ShmFrameOutput::ShmFrameOutput(const QString &name, const int slots)
+    : mName(name)
+    , mSlotCount(slots)
+    , mFd(-1)
+    , mMap(nullptr)
+    , mMapSize(0)
+    , mHeader(nullptr)
+    , mPublished(0)
+    , mFrameBytes(0)
+{
+}
+
+ShmFrameOutput::~ShmFrameOutput()
+{
+    close();
+}
+
+bool ShmFrameOutput::openSink(const QSize &size, const int stride, const double fps)
+{
+    const QByteArray name = mName.toLocal8Bit();
+    mFrameBytes = qint64(stride) * size.height();
+    const qint64 slotSize = (SlotHeaderSize + mFrameBytes + 63) & ~qint64(63);
+    const qint64 slotOffset = (qint64(sizeof(FrameRingHeader)) + 63) & ~qint64(63);
+    mMapSize = slotOffset + slotSize * mSlotCount;
+
+    /* a fresh object every time; readers of an old one keep their mapping */
+    shm_unlink(name.constData());
+    mFd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (mFd < 0 || ftruncate(mFd, off_t(mMapSize)) != 0) {
+        qWarning() << "[ShmFrameOutput::openSink] - cannot create" << mName << strerror(errno);
+        closeSink();
+        return false;
+    }
+    void *map = mmap(nullptr, size_t(mMapSize), PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    if (map == MAP_FAILED) {
+        qWarning() << "[ShmFrameOutput::openSink] - cannot map" << mName << strerror(errno);
+        closeSink();
+        return false;
+    }
+    mMap = static_cast<uchar *>(map);
+    mHeader = reinterpret_cast<FrameRingHeader *>(mMap);
+
+    /* ftruncate zero-fills, so only the non-zero fields are set; magic goes last */
+    mHeader->version = Version;
+    mHeader->headerSize = sizeof(FrameRingHeader);
+    mHeader->width = quint32(size.width());
+    mHeader->height = quint32(size.height());
+    mHeader->stride = quint32(stride);
+    memcpy(&mHeader->format, "BGRA", 4);
+    mHeader->slotCount = quint32(mSlotCount);
+    mHeader->slotSize = quint32(slotSize);
+    mHeader->fpsNumerator = quint32(qRound(fps * 1000));
+    mHeader->fpsDenominator = 1000;
+    mHeader->slotOffset = quint64(slotOffset);
+    mHeader->published.storeRelease(0);
+    memcpy(mHeader->magic, "QTTKRING", 8);
+
+    mPublished = 0;
+    qDebug() << "[ShmFrameOutput::openSink] - frames in" << mName << size << "x" << mSlotCount << "slots";
+    return true;
+}
+
+void ShmFrameOutput::closeSink()
+{
+    if (mMap != nullptr) {
+        munmap(mMap, size_t(mMapSize));
+        mMap = nullptr;
+        mHeader = nullptr;
+    }
+    if (mFd >= 0) {
+        ::close(mFd);
+        mFd = -1;
+        shm_unlink(mName.toLocal8Bit().constData());
+    }
+}
+
+ShmFrameOutput::FrameSlotHeader *ShmFrameOutput::slot(const quint64 frame) const
+{
+    return reinterpret_cast<FrameSlotHeader *>(
+        mMap + mHeader->slotOffset + (frame % quint64(mSlotCount)) * mHeader->slotSize);
+}
+
+uchar *ShmFrameOutput::pixels(const quint64 frame) const
+{
+    return reinterpret_cast<uchar *>(slot(frame)) + SlotHeaderSize;
+}
+
+uchar *ShmFrameOutput::beginFrame()
+{
+    /* a reader that reports progress and is a whole ring behind loses its oldest frame */
+    const quint64 consumed = mHeader->consumed.loadAcquire();
+    if (consumed != 0 && mPublished >= consumed + quint64(mSlotCount)) {
+        mOverruns.fetchAndAddRelaxed(1);
+    }
+
+    slot(mPublished)->sequence.fetchAndStoreOrdered(2 * mPublished + 1);
+    return pixels(mPublished);
+}
+
+void ShmFrameOutput::publishFrame(const quint64 index, const qint64 timestamp)
+{
+    FrameSlotHeader *header = slot(mPublished);
+    header->frameIndex = index;
+    header->timestamp = timestamp;
+    header->sequence.storeRelease(2 * mPublished + 2);
+
+    ++mPublished;
+    const Stats s = stats();
+    mHeader->dropped.store(s.dropped);
+    mHeader->duplicated.store(s.duplicated);
+    mHeader->published.storeRelease(mPublished);
+}
+
+qint64 ShmFrameOutput::repeatFrame(const quint64 first, const qint64 count)
+{
+    if (mPublished == 0) {
+        return 0;
+    }
+
+    /* more than a ring of repeats would only overwrite each other */
+    const qint64 copies = qMin<qint64>(count, mSlotCount);
+    for (quint64 index = first + quint64(count - copies); index < first + quint64(count); ++index) {
+        const uchar *previous = pixels(mPublished - 1);
+        uchar *bits = beginFrame();
+        memcpy(bits, previous, size_t(mFrameBytes));
+        publishFrame(index, timestamp(index));
+    }
+    return copies;
+}
+
+#endif
+
+class PipeFrameOutput::Writer : public QThread
+{
+public:
+    explicit Writer(PipeFrameOutput *output)
+        : mOutput(output)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        PipeFrameOutput *o = mOutput;
+
+        /* opening a FIFO waits for its reader, so it happens here and not in the frame loop */
+        QFile file;
+        QString error;
+        bool opened = false;
+        if (o->mPath == "-") {
+            opened = file.open(1, QIODevice::WriteOnly | QIODevice::Unbuffered);
+        } else {
+#ifdef Q_OS_UNIX
+            const int fd = openPath(&error);
+            opened = fd >= 0 && file.open(fd, QIODevice::WriteOnly | QIODevice::Unbuffered, QFileDevice::AutoCloseHandle);
+#else
+            file.setFileName(o->mPath);
+            opened = file.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+#endif
+        }
+
+        QMutexLocker locker(&o->mMutex);
+        if (!opened && !o->mStopping) {
+            qWarning() << "[PipeFrameOutput::Writer] - cannot open" << o->mPath
+                       << (error.isEmpty() ? file.errorString() : error);
+        }
+        o->mBroken = !opened;
+        for (;;) {
+            while (o->mQueue.isEmpty() && !o->mStopping) {
+                o->mQueued.wait(&o->mMutex);
+            }
+            if (o->mQueue.isEmpty()) {
+                break;
+            }
+
+            /*
+             * No QByteArray copy here, it would make the frame loop detach the
+             * buffer. The buffer stays queued while it is written, so repeats
+             * added meanwhile still go out after it.
+             */
+            const int buffer = o->mQueue.first();
+            const char *frame = o->mBuffers.at(buffer).constData();
+            const qint64 size = o->mBuffers.at(buffer).size();
+            const bool broken = o->mBroken;
+            locker.unlock();
+            const bool written = !broken && file.write(frame, size) == size;
+            locker.relock();
+
+            if (!written && !o->mBroken) {
+                qWarning() << "[PipeFrameOutput::Writer] - reader went away:" << file.errorString();
+                o->mBroken = true;
+            }
+            if (written && o->mRepeats.at(buffer) > 0) {
+                --o->mRepeats[buffer];
+                continue;
+            }
+            o->mRepeats[buffer] = 0;
+            o->mQueue.removeFirst();
+            o->mFree.append(buffer);
+        }
+    }
+
+private:
+#ifdef Q_OS_UNIX
+    /*
+     * A blocking open() of a FIFO nobody reads would never return, and
+     * closeSink() would wait for it forever. Opening without blocking fails
+     * with ENXIO until a reader appears, so it is retried until the output
+     * stops; the descriptor then blocks again for the writes.
+     */
+    int openPath(QString *error)
+    {
+        PipeFrameOutput *o = mOutput;
+        const QByteArray path = QFile::encodeName(o->mPath);
+
+        QMutexLocker locker(&o->mMutex);
+        for (;;) {
+            const int fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK, 0644);
+            if (fd >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+                return fd;
+            }
+            if (errno != ENXIO) {
+                *error = QString::fromLocal8Bit(strerror(errno));
+                return -1;
+            }
+            if (o->mStopping) {
+                return -1;
+            }
+            o->mQueued.wait(&o->mMutex, 50);
+        }
+    }
+#endif
+
+    PipeFrameOutput *mOutput;
+};
+
+PipeFrameOutput::PipeFrameOutput(const QString &path, const int buffers)
+    : mPath(path)
+    , mBufferCount(qMax(2, buffers))
+    , mWriter(nullptr)
+    , mCurrent(-1)
+    , mLast(-1)
+    , mStopping(false)
+    , mBroken(false)
+{
+}
+
+PipeFrameOutput::~PipeFrameOutput()
+{
+    close();
+}
+
+bool PipeFrameOutput::openSink(const QSize &size, const int stride, const double fps)
+{
+#ifdef Q_OS_UNIX
+    /* a closed reader must fail the write, not kill the process */
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    mBuffers.clear();
+    mFree.clear();
+    mQueue.clear();
+    for (int i = 0; i < mBufferCount; ++i) {
+        mBuffers.append(QByteArray(stride * size.height(), Qt::Uninitialized));
+        mFree.append(i);
+    }
+    mRepeats.fill(0, mBufferCount);
+    mCurrent = mLast = -1;
+    mStopping = mBroken = false;
+
+    mWriter = new Writer(this);
+    mWriter->start();
+    qDebug() << "[PipeFrameOutput::openSink] - rawvideo bgra" << size << "at" << fps << "fps to" << mPath;
+    return true;
+}
+
+void PipeFrameOutput::closeSink()
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mStopping = true;
+        mQueued.wakeAll();
+    }
+    mWriter->wait();
+    delete mWriter;
+    mWriter = nullptr;
+}
+
+uchar *PipeFrameOutput::beginFrame()
+{
+    QMutexLocker locker(&mMutex);
+    if (mBroken || mFree.isEmpty()) {
+        return nullptr;
+    }
+
+    /* the last frame is kept out of the way of new frames while others are free */
+    int pick = 0;
+    if (mFree.size() > 1 && mFree.at(0) == mLast) {
+        pick = 1;
+    }
+    mCurrent = mFree.takeAt(pick);
+    return reinterpret_cast<uchar *>(mBuffers[mCurrent].data());
+}
+
+void PipeFrameOutput::publishFrame(const quint64 index, const qint64 timestamp)
+{
+    Q_UNUSED(index);
+    Q_UNUSED(timestamp);
+
+    QMutexLocker locker(&mMutex);
+    mQueue.append(mCurrent);
+    mLast = mCurrent;
+    mCurrent = -1;
+    mQueued.wakeOne();
+}
+
+qint64 PipeFrameOutput::repeatFrame(const quint64 first, const qint64 count)
+{
+    Q_UNUSED(first);
+
+    QMutexLocker locker(&mMutex);
+    if (mLast < 0 || mBroken) {
+        return 0;
+    }
+
+    /* the last frame is the newest in the queue, or already written and free again */
+    if (mFree.removeOne(mLast)) {
+        mQueue.append(mLast);
+        mRepeats[mLast] = count - 1;
+        mQueued.wakeOne();
+    } else {
+        mRepeats[mLast] += count;
+    }
+    return count;
+}
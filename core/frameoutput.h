@@ -0,0 +1,200 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef FRAMEOUTPUT_H
+#define FRAMEOUTPUT_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+class RasterRenderWidget;
+
+/*
+ * Finished frames handed to an encoder or keyer without capturing the window.
+ *
+ * Frames go out on a fixed cadence: the output frame index is the scene time
+ * times the output rate. When the render loop misses output slots the previous
+ * frame is repeated into them (duplicated). A second render inside one slot, a
+ * frame the reader has no room for, and every missed slot the sink could not
+ * repeat are dropped, so frames + duplicated + dropped slots account for the
+ * whole stream. submit() copies the frame once into the sink and never waits
+ * on the reader.
+ */
+class FrameOutput
+{
+public:
+    struct Stats
+    {
+        quint64 frames;         // rendered frames published
+        quint64 dropped;        // rendered frames not published, and missed slots not repeated
+        quint64 duplicated;     // missed output slots filled with the previous frame
+        quint64 overruns;       // published frames the reader had not consumed when overwritten
+    };
+
+    FrameOutput();
+    virtual ~FrameOutput();
+
+    /* "shm:/<name>[,slots=<n>]" or "pipe:<path>", with "pipe:-" for stdout */
+    static FrameOutput *create(const QString &spec);
+
+    void setFrameRate(const double fps);
+    double frameRate() const { return mFps; }
+
+    /* frame loop only, after the source presented the frame at sceneTime */
+    void submit(const RasterRenderWidget *source, const double sceneTime);
+    void close();
+
+    Stats stats() const;
+    QString report() const;
+
+protected:
+    virtual bool openSink(const QSize &size, const int stride, const double fps) = 0;
+    virtual void closeSink() = 0;
+
+    /* memory for the next frame, or nullptr when the reader is too far behind */
+    virtual uchar *beginFrame() = 0;
+    virtual void publishFrame(const quint64 index, const qint64 timestamp) = 0;
+
+    /*
+     * The previously published frame for the count slots from index first on.
+     * Returns how many of them the sink emits, counted from the last one; the
+     * rest are dropped.
+     */
+    virtual qint64 repeatFrame(const quint64 first, const qint64 count) = 0;
+
+    qint64 timestamp(const quint64 index) const { return qint64(index * 1e9 / mFps); }
+
+    QAtomicInteger<quint64> mOverruns;
+
+private:
+    double mFps;
+    QSize mSize;
+    bool mOpen;
+    bool mHasFrame;
+    qint64 mLastIndex;
+
+    QAtomicInteger<quint64> mFrames;
+    QAtomicInteger<quint64> mDropped;
+    QAtomicInteger<quint64> mDuplicated;
+};
+
+#ifdef Q_OS_UNIX
+/*
+ * POSIX shared memory ring (shm_open). The mapping starts with a
+ * FrameRingHeader followed by slotCount slots of slotSize bytes, each a
+ * FrameSlotHeader with the pixels at +64. All fields are native endian.
+ *
+ * A reader maps the object read-only (or read-write to report "consumed"),
+ * takes the latest slot as (published - 1) % slotCount and checks the slot
+ * sequence before and after copying: odd means the slot is being written and
+ * a changed value means it was overwritten meanwhile. The writer never waits
+ * for readers. After a stall only the last slotCount missed slots are
+ * repeated; the earlier ones would be overwritten before a reader saw them.
+ * The object is unlinked when the output closes.
+ */
+class ShmFrameOutput : public FrameOutput
+{
+public:
+    enum { Version = 1, SlotHeaderSize = 64 };
+
+    struct FrameRingHeader
+    {
+        char magic[8];                      // "QTTKRING"
+        quint32 version;                    // Version
+        quint32 headerSize;                 // sizeof(FrameRingHeader)
+        quint32 width;
+        quint32 height;
+        quint32 stride;                     // bytes per row
+        quint32 format;                     // FourCC "BGRA": 8-bit B, G, R, A per pixel, opaque
+        quint32 slotCount;
+        quint32 slotSize;                   // bytes per slot, slot header included
+        quint32 fpsNumerator;
+        quint32 fpsDenominator;
+        quint64 slotOffset;                 // first slot from the start of the mapping
+        QAtomicInteger<quint64> published;  // frames published; written last (release)
+        QAtomicInteger<quint64> consumed;   // optional, set by a reader to frames it is done with
+        QAtomicInteger<quint64> dropped;
+        QAtomicInteger<quint64> duplicated;
+    };
+
+    struct FrameSlotHeader
+    {
+        QAtomicInteger<quint64> sequence;   // 2n + 1 while frame n is written, 2n + 2 once complete
+        quint64 frameIndex;                 // output frame number at the fixed cadence
+        qint64 timestamp;                   // ns, frameIndex / fps
+    };
+
+    ShmFrameOutput(const QString &name, const int slots);
+    ~ShmFrameOutput();
+
+protected:
+    bool openSink(const QSize &size, const int stride, const double fps) override;
+    void closeSink() override;
+    uchar *beginFrame() override;
+    void publishFrame(const quint64 index, const qint64 timestamp) override;
+    qint64 repeatFrame(const quint64 first, const qint64 count) override;
+
+private:
+    FrameSlotHeader *slot(const quint64 frame) const;
+    uchar *pixels(const quint64 frame) const;
+
+    QString mName;
+    int mSlotCount;
+    int mFd;
+    uchar *mMap;
+    qint64 mMapSize;
+    FrameRingHeader *mHeader;
+    quint64 mPublished;
+    qint64 mFrameBytes;
+};
+#endif
+
+/*
+ * Raw BGRA frames written to a file, a FIFO or stdout ("-"), e.g. for
+ *   ffmpeg -f rawvideo -pix_fmt bgra -s <w>x<h> -r <fps> -i -
+ * Writing happens on its own thread through a few frame buffers; when the
+ * reader falls behind and all of them are queued, frames are dropped. Missed
+ * slots are not copied: the last buffer is queued with a repeat count and the
+ * writer writes it that many more times, so every slot reaches the reader.
+ */
+class PipeFrameOutput : public FrameOutput
+{
+public:
+    explicit PipeFrameOutput(const QString &path, const int buffers = 4);
+    ~PipeFrameOutput();
+
+protected:
+    bool openSink(const QSize &size, const int stride, const double fps) override;
+    void closeSink() override;
+    uchar *beginFrame() override;
+    void publishFrame(const quint64 index, const qint64 timestamp) override;
+    qint64 repeatFrame(const quint64 first, const qint64 count) override;
+
+private:
+    class Writer;
+
+    QString mPath;
+    int mBufferCount;
+    Writer *mWriter;
+
+    QMutex mMutex;
+    QWaitCondition mQueued;
+    QVector<QByteArray> mBuffers;
+    QVector<int> mFree;
+    QVector<int> mQueue;
+    QVector<qint64> mRepeats;   // extra writes per buffer, for missed slots
+    int mCurrent;
+    int mLast;
+    bool mStopping;
+    bool mBroken;
+};
+
+#endif
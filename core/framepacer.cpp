@@ -0,0 +1,150 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "framepacer.h"
+
+#include <QThread>
+#include <QtMath>
+
+FramePacer::FramePacer(QObject *parent)
+    : QObject(parent)
+    , mActive(false)
+    , mPeriod(16666667)
+    , mSpinWindow(0)
+    , mNextDeadline(0)
+    , mStoppedAt(0)
+    , mStoppedTotal(0)
+{
+    mTimer.setSingleShot(true);
+    mTimer.setTimerType(Qt::PreciseTimer);
+    connect(&mTimer, &QTimer::timeout, this, &FramePacer::onTimeout);
+
+    mClock.start();
+    resetStats();
+}
+
+FramePacer::~FramePacer()
+{
+}
+
+void FramePacer::start()
+{
+    if (mActive) return;
+
+    const qint64 now = mClock.nsecsElapsed();
+    mStoppedTotal += now - mStoppedAt;
+    mNextDeadline = now + mPeriod;
+    mLastFrame = -1;
+    mActive = true;
+    schedule();
+}
+
+void FramePacer::stop()
+{
+    if (!mActive) return;
+
+    mTimer.stop();
+    mStoppedAt = mClock.nsecsElapsed();
+    mActive = false;
+}
+
+void FramePacer::setFrameRate(const double fps)
+{
+    if (fps <= 0.0) return;
+
+    mPeriod = qMax<qint64>(1, qRound64(1e9 / fps));
+    if (mActive) {
+        /* re-anchor the grid on the new period */
+        mNextDeadline = mClock.nsecsElapsed() + mPeriod;
+        mLastFrame = -1;
+        schedule();
+    }
+}
+
+qint64 FramePacer::sceneTime() const
+{
+    const qint64 now = mActive ? mClock.nsecsElapsed() : mStoppedAt;
+    return now - mStoppedTotal;
+}
+
+FramePacer::Stats FramePacer::stats() const
+{
+    Stats stats;
+    stats.frames = mFrames;
+    stats.missed = mMissed;
+    stats.meanInterval = mIntervals ? mIntervalSum / mIntervals / 1e6 : 0.0;
+    stats.rmsJitter = mIntervals ? qSqrt(mJitterSquareSum / mIntervals) / 1e6 : 0.0;
+    stats.maxJitter = mMaxJitter / 1e6;
+    return stats;
+}
+
+void FramePacer::resetStats()
+{
+    mLastFrame = -1;
+    mFrames = 0;
+    mIntervals = 0;
+    mMissed = 0;
+    mIntervalSum = 0.0;
+    mJitterSquareSum = 0.0;
+    mMaxJitter = 0;
+}
+
+QString FramePacer::report() const
+{
+    const Stats s = stats();
+    return QString("%1 Hz: %2 frames, %3 missed, interval %4 ms, jitter rms %5 ms / max %6 ms")
+        .arg(frameRate(), 0, 'f', 1)
+        .arg(s.frames)
+        .arg(s.missed)
+        .arg(s.meanInterval, 0, 'f', 3)
+        .arg(s.rmsJitter, 0, 'f', 3)
+        .arg(s.maxJitter, 0, 'f', 3);
+}
+
+void FramePacer::onTimeout()
+{
+    if (!mActive) return;
+
+    /* spin out the remainder the coarse timer could not hit */
+    qint64 now = mClock.nsecsElapsed();
+    if (mSpinWindow > 0) {
+        while (now < mNextDeadline) {
+            QThread::yieldCurrentThread();
+            now = mClock.nsecsElapsed();
+        }
+    }
+
+    if (mLastFrame >= 0) {
+        const qint64 interval = now - mLastFrame;
+        const qint64 jitter = qAbs(interval - mPeriod);
+        mIntervalSum += interval;
+        mJitterSquareSum += double(jitter) * double(jitter);
+        mMaxJitter = qMax(mMaxJitter, jitter);
+        ++mIntervals;
+    }
+    mLastFrame = now;
+    ++mFrames;
+
+    /* stay on the grid; deadlines that already passed are skipped, not queued */
+    mNextDeadline += mPeriod;
+    if (now >= mNextDeadline) {
+        const qint64 behind = (now - mNextDeadline) / mPeriod + 1;
+        mMissed += behind;
+        mNextDeadline += behind * mPeriod;
+    }
+
+    emit frame();
+
+    if (mActive) {
+        schedule();
+    }
+}
+
+void FramePacer::schedule()
+{
+    const qint64 remaining = mNextDeadline - mClock.nsecsElapsed() - mSpinWindow;
+    const int ms = remaining > 0 ? int((remaining + 500000) / 1000000) : 0;
+    mTimer.start(ms);
+}
@@ -0,0 +1,90 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QString>
+
+/*
+ * Deadline based frame clock.
+ * Frames are due at fixed points on a monotonic time grid (start + n * period),
+ * so integer millisecond timer granularity never accumulates into drift. The
+ * last part of the wait can optionally be spun to land closer to the deadline.
+ * Frame-to-frame intervals are recorded to report jitter.
+ */
+class FramePacer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats
+    {
+        quint64 frames;
+        quint64 missed;         // deadlines skipped because a frame ran late
+        double meanInterval;    // ms
+        double rmsJitter;       // ms, deviation of the interval from the period
+        double maxJitter;       // ms
+    };
+
+    explicit FramePacer(QObject *parent = Q_NULLPTR);
+    ~FramePacer();
+
+    void start();
+    void stop();
+    bool isActive() const { return mActive; }
+
+    void setFrameRate(const double fps);
+    double frameRate() const { return 1e9 / mPeriod; }
+    qint64 period() const { return mPeriod; }
+
+    void setSpinWindow(const qint64 nsecs) {
+        mSpinWindow = nsecs;
+    }
+    /* a coarse timer lets the OS batch wakeups; the grid still keeps the average rate */
+    void setTimerType(const Qt::TimerType type) {
+        mTimer.setTimerType(type);
+    }
+
+    /* monotonic time in ns that only advances while the pacer runs */
+    qint64 sceneTime() const;
+
+    Stats stats() const;
+    void resetStats();
+    QString report() const;
+
+signals:
+    void frame();
+
+private slots:
+    void onTimeout();
+
+private:
+    void schedule();
+
+    QTimer mTimer;
+    QElapsedTimer mClock;
+    bool mActive;
+
+    qint64 mPeriod;
+    qint64 mSpinWindow;
+    qint64 mNextDeadline;
+
+    qint64 mStoppedAt;
+    qint64 mStoppedTotal;
+
+    qint64 mLastFrame;
+    quint64 mFrames;
+    quint64 mIntervals;
+    quint64 mMissed;
+    double mIntervalSum;
+    double mJitterSquareSum;
+    qint64 mMaxJitter;
+};
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "glyphatlas.h"
+#include "composite.h"
+
+#include <QPainter>
+#include <QMutexLocker>
+
+namespace
+{
+
+/* source-over of a solid premultiplied color through a coverage mask */
+void blendMask(QImage &target, const QPoint &pos, const QImage &mask, const QRect &rect, const quint32 color)
+{
+    const QRect dst = QRect(pos, rect.size()) & target.rect();
+    if (dst.isEmpty()) {
+        return;
+    }
+
+    const CompositeKernels &kernels = Composite::kernels();
+    const int sx = rect.x() + (dst.x() - pos.x());
+    const int sy = rect.y() + (dst.y() - pos.y());
+    for (int y = 0; y < dst.height(); ++y) {
+        const uchar *src = mask.constScanLine(sy + y) + sx;
+        quint32 *out = reinterpret_cast<quint32 *>(target.scanLine(dst.y() + y)) + dst.x();
+        kernels.maskOver(out, src, color, dst.width());
+    }
+}
+
+}
+
+GlyphAtlas::GlyphAtlas(const int pageSize)
+    : mPageSize(pageSize)
+    , mShelfX(0)
+    , mShelfY(0)
+    , mShelfHeight(0)
+    , mGeneration(0)
+    , mHits(0)
+    , mMisses(0)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    qDeleteAll(mPages);
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph(const int fontId, const quint32 glyphIndex)
+{
+    const quint64 key = (quint64(fontId) << 32) | glyphIndex;
+
+    QMutexLocker locker(&mMutex);
+    QHash<quint64, Glyph>::const_iterator it = mGlyphs.constFind(key);
+    if (it != mGlyphs.constEnd()) {
+        ++mHits;
+        return it.value();
+    }
+
+    ++mMisses;
+    return mGlyphs.insert(key, rasterize(threadFont(fontId), glyphIndex)).value();
+}
+
+const QImage &GlyphAtlas::page(const int index) const
+{
+    QMutexLocker locker(&mMutex);
+    return *mPages.at(index);
+}
+
+void GlyphAtlas::drawGlyph(QImage &target, const QPointF &pen, const Glyph &glyph, const quint32 premultipliedColor) const
+{
+    if (glyph.page < 0) {
+        return;
+    }
+    const QPoint pos(qRound(pen.x()) + glyph.offset.x(), qRound(pen.y()) + glyph.offset.y());
+    blendMask(target, pos, page(glyph.page), glyph.rect, premultipliedColor);
+}
+
+void GlyphAtlas::drawGlyphRun(QImage &target, const QPointF &origin, const QGlyphRun &run, const QColor &color)
+{
+    const QRawFont font = run.rawFont();
+    const int id = fontId(font);
+    const QVector<quint32> indexes = run.glyphIndexes();
+    const QVector<QPointF> positions = run.positions();
+    const quint32 premultiplied = qPremultiply(color.rgba());
+
+    for (int i = 0; i < indexes.size(); ++i) {
+        drawGlyph(target, origin + positions.at(i), glyph(id, indexes.at(i)), premultiplied);
+    }
+}
+
+void GlyphAtlas::clear()
+{
+    QMutexLocker locker(&mMutex);
+    qDeleteAll(mPages);
+    mPages.clear();
+    mFontIds.clear();
+    mFontSources.clear();
+    ++mGeneration;
+    mGlyphs.clear();
+    mShelfX = mShelfY = mShelfHeight = 0;
+}
+
+int GlyphAtlas::glyphCount() const
+{
+    QMutexLocker locker(&mMutex);
+    return mGlyphs.size();
+}
+
+int GlyphAtlas::pageCount() const
+{
+    QMutexLocker locker(&mMutex);
+    return mPages.size();
+}
+
+qint64 GlyphAtlas::byteSize() const
+{
+    QMutexLocker locker(&mMutex);
+    qint64 bytes = 0;
+    for (const QImage *page : mPages) {
+        bytes += page->sizeInBytes();
+    }
+    return bytes;
+}
+
+quint64 GlyphAtlas::hits() const
+{
+    QMutexLocker locker(&mMutex);
+    return mHits;
+}
+
+quint64 GlyphAtlas::misses() const
+{
+    QMutexLocker locker(&mMutex);
+    return mMisses;
+}
+
+int GlyphAtlas::fontId(const QRawFont &font)
+{
+    const QString key = QString("%1|%2|%3|%4|%5")
+        .arg(font.familyName())
+        .arg(font.styleName())
+        .arg(font.weight())
+        .arg(int(font.style()))
+        .arg(font.pixelSize());
+
+    QMutexLocker locker(&mMutex);
+    QHash<QString, int>::const_iterator it = mFontIds.constFind(key);
+    if (it != mFontIds.constEnd()) {
+        return it.value();
+    }
+    const int id = mFontIds.size();
+    mFontIds.insert(key, id);
+
+    FontSource source;
+    source.family = font.familyName();
+    source.styleName = font.styleName();
+    source.weight = font.weight();
+    source.style = font.style();
+    source.hinting = font.hintingPreference();
+    source.pixelSize = font.pixelSize();
+    mFontSources.append(source);
+    return id;
+}
+
+QRawFont GlyphAtlas::threadFont(const int fontId)
+{
+    ThreadFonts &cached = mThreadFonts.localData();
+    if (cached.generation != mGeneration) {
+        cached.fonts.clear();
+        cached.generation = mGeneration;
+    }
+    QHash<int, QRawFont>::const_iterator it = cached.fonts.constFind(fontId);
+    if (it != cached.fonts.constEnd()) {
+        return it.value();
+    }
+
+    /* the run's own font, not a fallback for it: glyph indexes belong to one font file */
+    const FontSource &source = mFontSources.at(fontId);
+    QFont font(source.family);
+    font.setStyleName(source.styleName);
+    font.setWeight(source.weight);
+    font.setStyle(source.style);
+    font.setHintingPreference(source.hinting);
+    font.setStyleStrategy(QFont::NoFontMerging);
+    font.setPixelSize(qMax(1, qRound(source.pixelSize)));
+
+    QRawFont raw = QRawFont::fromFont(font);
+    raw.setPixelSize(source.pixelSize);
+    cached.fonts.insert(fontId, raw);
+    return raw;
+}
+
+GlyphAtlas::Glyph GlyphAtlas::rasterize(const QRawFont &font, const quint32 glyphIndex)
+{
+    Glyph g;
+    g.page = -1;
+
+    /* one pixel of padding keeps antialiased edges inside the mask */
+    const QRect box = font.boundingRect(glyphIndex).toAlignedRect().adjusted(-1, -1, 1, 1);
+    if (box.width() <= 2 || box.height() <= 2) {
+        return g;
+    }
+
+    QImage image(box.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QGlyphRun run;
+        run.setRawFont(font);
+        run.setGlyphIndexes(QVector<quint32>() << glyphIndex);
+        run.setPositions(QVector<QPointF>() << QPointF(-box.x(), -box.y()));
+
+        QPainter painter(&image);
+        painter.setPen(Qt::white);
+        painter.drawGlyphRun(QPointF(0, 0), run);
+    }
+
+    QPoint pos;
+    g.page = allocate(box.size(), &pos);
+    g.rect = QRect(pos, box.size());
+    g.offset = box.topLeft();
+
+    /* the page is never shared, so writing through scanLine() does not detach it */
+    QImage *page = mPages[g.page];
+    for (int y = 0; y < box.height(); ++y) {
+        const QRgb *src = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        uchar *dst = page->scanLine(pos.y() + y) + pos.x();
+        for (int x = 0; x < box.width(); ++x) {
+            dst[x] = qAlpha(src[x]);
+        }
+    }
+    return g;
+}
+
+int GlyphAtlas::allocate(const QSize &size, QPoint *pos)
+{
+    /* simple shelf packing: fill rows left to right, open a new page when full */
+    if (!mPages.isEmpty() && mShelfX + size.width() > mPages.last()->width()) {
+        mShelfY += mShelfHeight;
+        mShelfX = 0;
+        mShelfHeight = 0;
+    }
+    if (mPages.isEmpty() || mShelfY + size.height() > mPages.last()->height()
+        || size.width() > mPages.last()->width()) {
+        QImage *page = new QImage(qMax(mPageSize, size.width()), qMax(mPageSize, size.height()), QImage::Format_Alpha8);
+        page->fill(0);
+        mPages.append(page);
+        mShelfX = mShelfY = mShelfHeight = 0;
+    }
+
+    *pos = QPoint(mShelfX, mShelfY);
+    mShelfX += size.width();
+    mShelfHeight = qMax(mShelfHeight, size.height());
+    return mPages.size() - 1;
+}
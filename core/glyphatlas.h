@@ -0,0 +1,106 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QImage>
+#include <QColor>
+#include <QPoint>
+#include <QRect>
+#include <QFont>
+#include <QRawFont>
+#include <QGlyphRun>
+#include <QString>
+#include <QThreadStorage>
+
+/*
+ * Cache of rasterized glyph coverage masks, keyed by (font, pixel size, glyph id).
+ * Every glyph is rasterized once into an Alpha8 atlas page; messages are then
+ * built by blending the cached masks in the requested color.
+ *
+ * Lookups and drawing may run on rasterization worker threads. A QRawFont
+ * belongs to the thread that created it, so fontId() records what the font
+ * is and misses are rasterized with a raw font each thread builds for
+ * itself. Misses are rasterized under the atlas lock. Pages never move once
+ * allocated, so drawing only holds the lock long enough to find the page.
+ * clear() must not race with rasterization.
+ */
+class GlyphAtlas
+{
+public:
+    struct Glyph
+    {
+        int page;       // -1 for glyphs without ink (spaces)
+        QRect rect;     // location in the page
+        QPoint offset;  // top-left of the mask relative to the pen position on the baseline
+    };
+
+    explicit GlyphAtlas(const int pageSize = 1024);
+    ~GlyphAtlas();
+
+    /* font must belong to the calling thread; the id is valid on every thread */
+    int fontId(const QRawFont &font);
+    Glyph glyph(const int fontId, const quint32 glyphIndex);
+    const QImage &page(const int index) const;
+
+    void drawGlyph(QImage &target, const QPointF &pen, const Glyph &glyph, const quint32 premultipliedColor) const;
+    void drawGlyphRun(QImage &target, const QPointF &origin, const QGlyphRun &run, const QColor &color);
+
+    void clear();
+
+    int glyphCount() const;
+    int pageCount() const;
+    qint64 byteSize() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    /* enough to find the same font again from another thread */
+    struct FontSource
+    {
+        QString family;
+        QString styleName;
+        int weight;
+        QFont::Style style;
+        QFont::HintingPreference hinting;
+        qreal pixelSize;
+    };
+
+    /* raw fonts one thread built, dropped when clear() renumbers the ids */
+    struct ThreadFonts
+    {
+        ThreadFonts() : generation(0) {}
+
+        quint64 generation;
+        QHash<int, QRawFont> fonts;
+    };
+
+    QRawFont threadFont(const int fontId);
+    Glyph rasterize(const QRawFont &font, const quint32 glyphIndex);
+    int allocate(const QSize &size, QPoint *pos);
+
+    mutable QMutex mMutex;
+
+    int mPageSize;
+    QVector<QImage *> mPages;
+    int mShelfX;
+    int mShelfY;
+    int mShelfHeight;
+
+    QHash<QString, int> mFontIds;
+    QVector<FontSource> mFontSources;   // by font id
+    QThreadStorage<ThreadFonts> mThreadFonts;
+    quint64 mGeneration;
+    QHash<quint64, Glyph> mGlyphs;
+
+    quint64 mHits;
+    quint64 mMisses;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "itemstore.h"
+
+#include <algorithm>
+
+ItemStore::ItemStore()
+    : mExtent(0.0)
+    , mPacked(true)
+{
+}
+
+void ItemStore::clear()
+{
+    mX.clear();
+    mWidth.clear();
+    mGap.clear();
+    mHandle.clear();
+    mExtent = 0.0;
+    mPacked = true;
+}
+
+void ItemStore::reserve(const int size)
+{
+    mX.reserve(size);
+    mWidth.reserve(size);
+    mGap.reserve(size);
+    mHandle.reserve(size);
+}
+
+int ItemStore::append(const float width, const float gap, const int handle)
+{
+    mX.append(0.0);
+    mWidth.append(width);
+    mGap.append(gap);
+    mHandle.append(handle);
+    mPacked = false;
+    return mWidth.size() - 1;
+}
+
+void ItemStore::setWidth(const int index, const float width)
+{
+    if (mWidth.at(index) != width) {
+        mWidth[index] = width;
+        mPacked = false;
+    }
+}
+
+void ItemStore::pack()
+{
+    if (mPacked) {
+        return;
+    }
+
+    /* the advances are independent and vectorize; the running sum is one add per item */
+    const int count = mWidth.size();
+    double *x = mX.data();
+    const float *width = mWidth.constData();
+    const float *gap = mGap.constData();
+    for (int i = 0; i < count; ++i) {
+        x[i] = double(width[i]) + gap[i];
+    }
+    double pos = 0.0;
+    for (int i = 0; i < count; ++i) {
+        const double advance = x[i];
+        x[i] = pos;
+        pos += advance;
+    }
+    mExtent = pos;
+    mPacked = true;
+}
+
+double ItemStore::extent()
+{
+    pack();
+    return mExtent;
+}
+
+void ItemStore::query(const double left, const double right, int *first, int *end)
+{
+    pack();
+
+    const double *begin = mX.constData();
+    const double *stop = begin + mX.size();
+
+    /* the last item starting at or before left may still reach into the range */
+    int from = int(std::upper_bound(begin, stop, left) - begin) - 1;
+    if (from < 0 || begin[from] + mWidth.at(from) <= left) {
+        ++from;
+    }
+    *first = from;
+    *end = qMax(from, int(std::lower_bound(begin, stop, right) - begin));
+}
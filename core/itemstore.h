@@ -0,0 +1,59 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef ITEMSTORE_H
+#define ITEMSTORE_H
+
+#include <QVector>
+
+/*
+ * A row of items laid out back to back, kept as parallel arrays (structure
+ * of arrays): x, width, the gap after the item and a caller handle.
+ *
+ * A width change only marks the row; pack() then recomputes every x in one
+ * pass over contiguous arrays, with no per-item objects or containers to walk.
+ * Widths and gaps are floats; x is a running sum that reaches tens of millions
+ * of pixels on a large board, past the 2^24 a float holds exactly, so it and
+ * the extent are doubles.
+ * Because x is sorted, query() finds the items overlapping a range by binary
+ * search, so culling costs O(log n + visible) for thousands of items.
+ */
+class ItemStore
+{
+public:
+    ItemStore();
+
+    void clear();
+    void reserve(const int size);
+
+    /* appended at the end of the row; returns the index */
+    int append(const float width, const float gap, const int handle);
+
+    int size() const { return mWidth.size(); }
+    double x(const int index) const { return mX.at(index); }
+    float width(const int index) const { return mWidth.at(index); }
+    int handle(const int index) const { return mHandle.at(index); }
+
+    void setWidth(const int index, const float width);
+
+    /* lays the row out again if a width changed since the last pack */
+    void pack();
+
+    /* end of the last item and its gap */
+    double extent();
+
+    /* items overlapping [left, right) are [*first, *end) */
+    void query(const double left, const double right, int *first, int *end);
+
+private:
+    QVector<double> mX;
+    QVector<float> mWidth;
+    QVector<float> mGap;
+    QVector<int> mHandle;
+    double mExtent;
+    bool mPacked;
+};
+
+#endif
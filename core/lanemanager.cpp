@@ -0,0 +1,196 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "lanemanager.h"
+
+LaneManager::LaneManager(GlyphAtlas *atlas, QThreadPool *pool)
+    : mGlyphAtlas(atlas)
+    , mThreadPool(pool)
+    , mWidth(1920)
+    , mLastFrameTime(0.0)
+    , mWholePixels(false)
+    , mShortLookahead(false)
+{
+}
+
+LaneManager::~LaneManager()
+{
+    qDeleteAll(mLanes);
+}
+
+TickerLane *LaneManager::addLane(const QString &name, const int height)
+{
+    TickerLane *lane = new TickerLane(name, mGlyphAtlas, mThreadPool);
+    lane->setQuality(mWholePixels, mShortLookahead);
+    mLanes.append(lane);
+    mHeights.append(height);
+    relayout();
+    return lane;
+}
+
+void LaneManager::clear()
+{
+    qDeleteAll(mLanes);
+    mLanes.clear();
+    mHeights.clear();
+}
+
+TickerLane *LaneManager::lane(const QString &name) const
+{
+    for (TickerLane *lane : mLanes) {
+        if (lane->name() == name) {
+            return lane;
+        }
+    }
+    return nullptr;
+}
+
+void LaneManager::setWidth(const int width)
+{
+    mWidth = width;
+    relayout();
+}
+
+void LaneManager::setHeight(const int index, const int height)
+{
+    mHeights[index] = height;
+    relayout();
+}
+
+void LaneManager::setSize(const QSize &size)
+{
+    const int count = qMax(1, mLanes.size());
+    mWidth = size.width();
+    for (int i = 0; i < mLanes.size(); ++i) {
+        const int top = size.height() * i / count;
+        const int bottom = size.height() * (i + 1) / count;
+        mHeights[i] = bottom - top;
+    }
+    relayout();
+}
+
+QSize LaneManager::size() const
+{
+    int height = 0;
+    for (const int laneHeight : mHeights) {
+        height += laneHeight;
+    }
+    return QSize(mWidth, height);
+}
+
+void LaneManager::applyUpdates(const QVector<FeedUpdate> &updates)
+{
+    if (mLanes.isEmpty()) {
+        return;
+    }
+
+    for (const FeedUpdate &update : updates) {
+        const int slash = update.key.indexOf('/');
+        TickerLane *target = (slash > 0) ? lane(update.key.left(slash)) : nullptr;
+        if (target != nullptr) {
+            target->update(update.key.mid(slash + 1), update.text);
+        } else {
+            mLanes.first()->update(update.key, update.text);
+        }
+    }
+}
+
+void LaneManager::advance(const double frameTime)
+{
+    /* one clock for every lane so they never drift against each other */
+    const double elapsed = frameTime - mLastFrameTime;
+    mLastFrameTime = frameTime;
+    for (TickerLane *lane : mLanes) {
+        lane->advance(elapsed);
+    }
+}
+
+void LaneManager::seek(const double frameTime)
+{
+    mLastFrameTime = frameTime;
+    for (TickerLane *lane : mLanes) {
+        lane->seek(frameTime);
+    }
+}
+
+void LaneManager::compose(SceneTarget *target)
+{
+    for (TickerLane *lane : mLanes) {
+        lane->compose(target);
+    }
+}
+
+void LaneManager::setQuality(const bool wholePixels, const bool shortLookahead)
+{
+    mWholePixels = wholePixels;
+    mShortLookahead = shortLookahead;
+    for (TickerLane *lane : mLanes) {
+        lane->setQuality(wholePixels, shortLookahead);
+    }
+}
+
+bool LaneManager::isMoving() const
+{
+    for (TickerLane *lane : mLanes) {
+        if (lane->isMoving()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int LaneManager::pendingRasters() const
+{
+    int pending = 0;
+    for (const TickerLane *lane : mLanes) {
+        pending += lane->strip().pendingTiles() + lane->board().pendingSegments() + lane->playlist().pendingTiles();
+    }
+    return pending;
+}
+
+qint64 LaneManager::byteSize() const
+{
+    qint64 bytes = 0;
+    for (const TickerLane *lane : mLanes) {
+        bytes += lane->strip().byteSize() + lane->board().byteSize() + lane->playlist().byteSize();
+    }
+    return bytes;
+}
+
+quint64 LaneManager::droppedFrames() const
+{
+    quint64 dropped = 0;
+    for (const TickerLane *lane : mLanes) {
+        dropped += lane->strip().droppedFrames() + lane->playlist().droppedFrames();
+    }
+    return dropped;
+}
+
+int LaneManager::boardItems() const
+{
+    int items = 0;
+    for (const TickerLane *lane : mLanes) {
+        items += lane->board().itemCount();
+    }
+    return items;
+}
+
+quint64 LaneManager::rasterizedSegments() const
+{
+    quint64 segments = 0;
+    for (const TickerLane *lane : mLanes) {
+        segments += lane->board().rasterizedSegments();
+    }
+    return segments;
+}
+
+void LaneManager::relayout()
+{
+    int top = 0;
+    for (int i = 0; i < mLanes.size(); ++i) {
+        mLanes.at(i)->setGeometry(top, QSize(mWidth, mHeights.at(i)));
+        top += mHeights.at(i);
+    }
+}
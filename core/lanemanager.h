@@ -0,0 +1,79 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef LANEMANAGER_H
+#define LANEMANAGER_H
+
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include "tickerlane.h"
+#include "feedingest.h"
+
+class GlyphAtlas;
+class SceneTarget;
+class QThreadPool;
+
+/*
+ * Stacked lanes driven by one frame loop: advance() moves every lane in one
+ * pass from the frame clock and compose() draws all of them into the same
+ * scene, so N lanes cost one timer wakeup and one present per frame.
+ *
+ * Feed keys of the form "<lane>/<key>" go to the named lane; plain keys go
+ * to the first lane.
+ */
+class LaneManager
+{
+public:
+    LaneManager(GlyphAtlas *atlas, QThreadPool *pool);
+    ~LaneManager();
+
+    TickerLane *addLane(const QString &name, const int height);
+    void clear();
+
+    int count() const { return mLanes.size(); }
+    TickerLane *lane(const int index) const { return mLanes.at(index); }
+    TickerLane *lane(const QString &name) const;
+
+    /* lanes are stacked top to bottom across the full width */
+    void setWidth(const int width);
+    void setHeight(const int index, const int height);
+    /* total size, the height split evenly between the lanes */
+    void setSize(const QSize &size);
+    QSize size() const;
+
+    void applyUpdates(const QVector<FeedUpdate> &updates);
+    void advance(const double frameTime);
+    /* every lane where it is at frameTime, independent of earlier frames */
+    void seek(const double frameTime);
+    void compose(SceneTarget *target);
+
+    /* applied to every lane, including lanes added later */
+    void setQuality(const bool wholePixels, const bool shortLookahead);
+
+    /* false while no lane would change between frames */
+    bool isMoving() const;
+
+    int pendingRasters() const;
+    qint64 byteSize() const;
+    quint64 droppedFrames() const;
+    int boardItems() const;
+    quint64 rasterizedSegments() const;
+
+private:
+    void relayout();
+
+    GlyphAtlas *mGlyphAtlas;
+    QThreadPool *mThreadPool;
+    QVector<TickerLane *> mLanes;
+    QVector<int> mHeights;
+    int mWidth;
+    double mLastFrameTime;
+    bool mWholePixels;
+    bool mShortLookahead;
+};
+
+#endif
@@ -4,12 +4,261 @@
  */
 
 #include "qtticker.h"
+#include "renderbackend.h"
+#include "tickerengine.h"
+#include "offlinerenderer.h"
+#include "rasterdiskcache.h"
+
 #include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QDebug>
+#include <QFile>
+#include <QTimer>
+
+/*
+ * "name[,speed=px/s][,dir=left|right][,height=px][,phases=n][,playlist=file][,gap=px][,text=...]";
+ * text takes the rest, a playlist file has one item per line
+ */
+static void addLane(LaneManager *lanes, const QString &spec, const double defaultSpeed, const int defaultPhases)
+{
+    QString options = spec;
+    QString text;
+    const int textAt = options.indexOf(",text=");
+    if (textAt >= 0) {
+        text = options.mid(textAt + 6);
+        options.truncate(textAt);
+    }
+
+    const QStringList fields = options.split(',', QString::SkipEmptyParts);
+    const QString name = fields.isEmpty() ? QString("lane%1").arg(lanes->count()) : fields.first();
+    int height = 90;
+    double speed = defaultSpeed;
+    TickerLane::Direction direction = TickerLane::RightToLeft;
+    int phases = defaultPhases;
+    QString playlist;
+    int gap = 200;
+    for (int i = 1; i < fields.size(); ++i) {
+        const QString key = fields.at(i).section('=', 0, 0);
+        const QString value = fields.at(i).section('=', 1);
+        if (key == "speed") {
+            speed = value.toDouble();
+        } else if (key == "dir") {
+            direction = (value == "right") ? TickerLane::LeftToRight : TickerLane::RightToLeft;
+        } else if (key == "height") {
+            height = qMax(1, value.toInt());
+        } else if (key == "phases") {
+            phases = value.toInt();
+        } else if (key == "playlist") {
+            playlist = value;
+        } else if (key == "gap") {
+            gap = value.toInt();
+        }
+    }
+
+    TickerLane *lane = lanes->addLane(name, height);
+    lane->setSpeed(speed);
+    lane->setDirection(direction);
+    lane->setSubpixelPhases(phases);
+    lane->setMessage(text.isEmpty() ? name : text);
+
+    if (!playlist.isEmpty()) {
+        QFile file(playlist);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qWarning() << "[addLane] - cannot read playlist" << playlist << file.errorString();
+            return;
+        }
+        QStringList items;
+        while (!file.atEnd()) {
+            const QString item = QString::fromUtf8(file.readLine()).trimmed();
+            if (!item.isEmpty()) {
+                items.append(item);
+            }
+        }
+        lane->setPlaylist(items, gap);
+    }
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    QtTicker w;
-    w.show();
-    return a.exec();
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption backendOption(
+        "backend"
+        , QString("Render backend (%1).").arg(RenderBackend::availableNames().join(", "))
+        , "name", RenderBackend::defaultName());
+    parser.addOption(backendOption);
+    QCommandLineOption fpsOption("fps", "Frame rate.", "fps", "60");
+    parser.addOption(fpsOption);
+    QCommandLineOption profileOption(
+        "profile", "Frame scheduling: throughput, latency or power (idles when nothing moves).", "name", "power");
+    parser.addOption(profileOption);
+    QCommandLineOption fixedQualityOption(
+        "fixed-quality", "Never drop sub-pixel phases, lookahead or frame rate when frames run over budget.");
+    parser.addOption(fixedQualityOption);
+    QCommandLineOption speedOption("speed", "Scroll speed in pixels per second.", "px/s", "25");
+    parser.addOption(speedOption);
+    QCommandLineOption laneOption(
+        "lane", "Add a lane (repeatable): name[,speed=px/s][,dir=left|right][,height=px][,phases=n]"
+                "[,playlist=file][,gap=px][,text=...].", "spec");
+    parser.addOption(laneOption);
+    QCommandLineOption phasesOption(
+        "subpixel-phases", "Pre-shifted copies of every tile for sub-pixel scrolling, 1 to 16 (1 draws at whole pixels).",
+        "n", "1");
+    parser.addOption(phasesOption);
+    QCommandLineOption feedStdinOption("feed-stdin", "Read feed records from stdin.");
+    parser.addOption(feedStdinOption);
+    QCommandLineOption feedPipeOption("feed-pipe", "Read feed records from a named pipe.", "path");
+    parser.addOption(feedPipeOption);
+    QCommandLineOption feedSocketOption("feed-socket", "Accept feed records on a local socket.", "name");
+    parser.addOption(feedSocketOption);
+    QCommandLineOption metricsSocketOption(
+        "metrics-socket", "Serve frame metrics (Prometheus text or JSON) on a local socket.", "name");
+    parser.addOption(metricsSocketOption);
+    QCommandLineOption scrollBlitOption(
+        "scroll-blit", "Shift the previous frame and only redraw what scrolled in or changed.");
+    parser.addOption(scrollBlitOption);
+    QCommandLineOption uploadsOption(
+        "uploads", "Keep composed images resident as textures in the backend's pixel format, counting upload bytes.");
+    parser.addOption(uploadsOption);
+    QCommandLineOption hudOption("hud", "Draw frame metrics on top of the ticker.");
+    parser.addOption(hudOption);
+    QCommandLineOption frameOutputOption(
+        "frame-output", "Also write frames to shm:/<name>[,slots=<n>] or pipe:<path|-> (raster backend).", "spec");
+    parser.addOption(frameOutputOption);
+    QCommandLineOption outputsOption("outputs", "Number of ticker windows driven by one engine.", "n", "1");
+    parser.addOption(outputsOption);
+    QCommandLineOption wallOption("wall", "Span the lanes across the outputs side by side instead of mirroring them.");
+    parser.addOption(wallOption);
+    QCommandLineOption parallelOutputsOption(
+        "parallel-outputs", "Compose and present every output on its own thread.");
+    parser.addOption(parallelOutputsOption);
+    QCommandLineOption pipelineOption(
+        "pipeline", "Simulate on the frame loop while a present thread composes and presents the raster outputs.");
+    parser.addOption(pipelineOption);
+    QCommandLineOption sizeOption("size", "Size of all lanes together, split evenly between them.", "WxH");
+    parser.addOption(sizeOption);
+    QCommandLineOption exportOption(
+        "export", "Render offline to <name>.png (numbered frames) or <name>.y4m and quit.", "path");
+    parser.addOption(exportOption);
+    QCommandLineOption durationOption("duration", "Length of the export.", "s", "10");
+    parser.addOption(durationOption);
+    QCommandLineOption exportThreadsOption("export-threads", "Export threads, 0 for every core.", "n", "0");
+    parser.addOption(exportThreadsOption);
+    QCommandLineOption rasterCacheOption(
+        "raster-cache", "Keep rasterized tiles and segments in this file between runs.", "path");
+    parser.addOption(rasterCacheOption);
+    QCommandLineOption quitAfterOption(
+        "quit-after", "Quit after the given number of milliseconds.", "ms");
+    parser.addOption(quitAfterOption);
+    parser.process(a);
+
+    /* the same lanes for the live engine and for every export worker */
+    const auto setupLanes = [&parser, &laneOption, &speedOption, &phasesOption, &sizeOption](LaneManager *lanes) {
+        const double speed = parser.value(speedOption).toDouble();
+        const int phases = parser.value(phasesOption).toInt();
+        lanes->clear();
+        if (parser.isSet(laneOption)) {
+            for (const QString &spec : parser.values(laneOption)) {
+                addLane(lanes, spec, speed, phases);
+            }
+        } else {
+            TickerLane *lane = lanes->addLane("main", 90);
+            lane->setSpeed(speed);
+            lane->setSubpixelPhases(phases);
+            lane->setMessage("Test Message");
+        }
+        if (parser.isSet(sizeOption)) {
+            const QStringList size = parser.value(sizeOption).split('x');
+            lanes->setSize(QSize(size.value(0).toInt(), size.value(1).toInt()));
+        }
+    };
+
+    if (parser.isSet(exportOption)) {
+        OfflineRenderer renderer;
+        renderer.setSetup(setupLanes);
+        renderer.setFrameRate(parser.value(fpsOption).toDouble());
+        renderer.setDuration(parser.value(durationOption).toDouble());
+        renderer.setThreadCount(parser.value(exportThreadsOption).toInt());
+        return renderer.render(parser.value(exportOption)) ? 0 : 1;
+    }
+
+    /* open before the lanes are built, so the first tiles already come from disk */
+    QTimer rasterCacheTimer;
+    if (parser.isSet(rasterCacheOption)) {
+        RasterDiskCache::global()->open(parser.value(rasterCacheOption));
+
+        /* a power cut loses at most a few minutes of rasters; the frame loop does not wait for the disk */
+        QObject::connect(&rasterCacheTimer, &QTimer::timeout, [] { RasterDiskCache::global()->saveInBackground(); });
+        rasterCacheTimer.start(5 * 60 * 1000);
+    }
+
+    TickerEngine engine;
+    engine.setFrameRate(parser.value(fpsOption).toDouble());
+    engine.setParallelOutputs(parser.isSet(parallelOutputsOption));
+    engine.setPipelined(parser.isSet(pipelineOption));
+
+    TickerEngine::Profile profile = TickerEngine::Power;
+    if (!TickerEngine::parseProfile(parser.value(profileOption), &profile)) {
+        qWarning() << "[main] - unknown profile" << parser.value(profileOption) << "- using power";
+    }
+    engine.setProfile(profile);
+    engine.setAdaptiveQuality(!parser.isSet(fixedQualityOption));
+
+    LaneManager *lanes = engine.lanes();
+    setupLanes(lanes);
+
+    if (parser.isSet(feedStdinOption)) {
+        engine.feed()->openStdin();
+    }
+    for (const QString &path : parser.values(feedPipeOption)) {
+        engine.feed()->openPipe(path);
+    }
+    for (const QString &name : parser.values(feedSocketOption)) {
+        engine.feed()->openLocalSocket(name);
+    }
+
+    /* a wall is one scene as wide as all outputs, each window showing its slice */
+    const int outputs = qMax(1, parser.value(outputsOption).toInt());
+    const QSize outputSize = lanes->size();
+    const bool wall = parser.isSet(wallOption);
+    if (wall) {
+        lanes->setWidth(outputSize.width() * outputs);
+    }
+
+    QList<QtTicker *> windows;
+    for (int i = 0; i < outputs; ++i) {
+        QtTicker *w = new QtTicker(parser.value(backendOption), &engine);
+        if (wall) {
+            w->setViewport(QRect(QPoint(outputSize.width() * i, 0), outputSize));
+            w->move(outputSize.width() * i, 0);
+        } else {
+            w->move(0, outputSize.height() * i);
+        }
+        if (i == 0 && parser.isSet(metricsSocketOption)) {
+            w->serveMetrics(parser.value(metricsSocketOption));
+        }
+        if (i == 0) {
+            for (const QString &spec : parser.values(frameOutputOption)) {
+                w->addFrameOutput(spec);
+            }
+        }
+        w->setHudVisible(parser.isSet(hudOption));
+        w->setScrollBlit(parser.isSet(scrollBlitOption));
+        w->setUploads(parser.isSet(uploadsOption));
+        w->show();
+        windows.append(w);
+    }
+
+    if (parser.isSet(quitAfterOption)) {
+        QTimer::singleShot(parser.value(quitAfterOption).toInt(), &a, &QApplication::quit);
+    }
+    const int result = a.exec();
+
+    /* the windows are outputs of the engine and go first */
+    qDeleteAll(windows);
+    RasterDiskCache::global()->close();
+    return result;
 }
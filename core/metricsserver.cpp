@@ -0,0 +1,72 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "metricsserver.h"
+#include "framemetrics.h"
+
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+MetricsServer::MetricsServer(FrameMetrics *metrics, QObject *parent)
+    : QObject(parent)
+    , mMetrics(metrics)
+    , mServer(new QLocalServer(this))
+{
+    connect(mServer, &QLocalServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+MetricsServer::~MetricsServer()
+{
+}
+
+bool MetricsServer::listen(const QString &serverName)
+{
+    QLocalServer::removeServer(serverName);
+    if (!mServer->listen(serverName)) {
+        qWarning() << "[MetricsServer::listen] - cannot listen on" << serverName
+                   << ":" << mServer->errorString();
+        return false;
+    }
+    return true;
+}
+
+QString MetricsServer::fullServerName() const
+{
+    return mServer->fullServerName();
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QLocalSocket *socket = mServer->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            if (socket->canReadLine()) {
+                respond(socket);
+            }
+        });
+    }
+}
+
+void MetricsServer::respond(QLocalSocket *socket)
+{
+    /* only the request line matters; headers are ignored */
+    const QByteArray request = socket->readLine().trimmed();
+    socket->disconnect(this);
+
+    const bool http = request.startsWith("GET ");
+    const QByteArray target = http ? request.split(' ').value(1) : request;
+    const bool json = target.contains("json");
+
+    const QByteArray body = json ? mMetrics->toJson() : mMetrics->toPrometheus();
+    if (http) {
+        QByteArray header = "HTTP/1.0 200 OK\r\nContent-Type: ";
+        header += json ? "application/json" : "text/plain; version=0.0.4";
+        header += "\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n";
+        socket->write(header);
+    }
+    socket->write(body);
+    socket->disconnectFromServer();
+}
@@ -0,0 +1,46 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+class FrameMetrics;
+class QLocalServer;
+class QLocalSocket;
+
+/*
+ * Serves FrameMetrics on a local socket, one snapshot per connection.
+ * The request is either an HTTP GET (/metrics for Prometheus text,
+ * /metrics.json for JSON), so `curl --unix-socket` and scrape proxies work,
+ * or a bare line "prometheus" / "json".
+ *
+ * Lives on the frame loop's thread; it only costs anything when scraped.
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(FrameMetrics *metrics, QObject *parent = Q_NULLPTR);
+    ~MetricsServer();
+
+    bool listen(const QString &serverName);
+    QString fullServerName() const;
+
+private slots:
+    void onNewConnection();
+
+private:
+    void respond(QLocalSocket *socket);
+
+    FrameMetrics *mMetrics;
+    QLocalServer *mServer;
+};
+
+#endif
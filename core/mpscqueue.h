@@ -0,0 +1,81 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QAtomicPointer>
+#include <QAtomicInt>
+
+#include <utility>
+
+/*
+ * Unbounded lock-free multi-producer / single-consumer queue
+ * (intrusive linked list with a stub node, after D. Vyukov).
+ * push() may be called from any thread, pop() only from the consumer.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : mHead(new Node())
+        , mSize(0)
+    {
+        mTail = mHead.loadAcquire();
+    }
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value)) {
+        }
+        delete mTail;
+    }
+
+    void push(T value)
+    {
+        Node *node = new Node();
+        node->value = std::move(value);
+        mSize.fetchAndAddRelaxed(1);
+
+        Node *prev = mHead.fetchAndStoreAcquireRelease(node);
+        prev->next.storeRelease(node);
+    }
+
+    bool pop(T &value)
+    {
+        Node *tail = mTail;
+        Node *next = tail->next.loadAcquire();
+        if (next == nullptr) {
+            return false;
+        }
+
+        value = std::move(next->value);
+        mTail = next;
+        mSize.fetchAndAddRelaxed(-1);
+        delete tail;
+        return true;
+    }
+
+    /* approximate while producers are active */
+    int size() const { return mSize.load(); }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) {}
+        QAtomicPointer<Node> next;
+        T value;
+    };
+
+    QAtomicPointer<Node> mHead;
+    Node *mTail;
+    QAtomicInt mSize;
+
+    Q_DISABLE_COPY(MpscQueue)
+};
+
+#endif
@@ -0,0 +1,275 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "offlinerenderer.h"
+#include "glyphatlas.h"
+#include "lanemanager.h"
+#include "rasterrenderwidget.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+
+class OfflineRenderer::Worker : public QThread
+{
+public:
+    Worker(OfflineRenderer *renderer, RasterRenderWidget *backend)
+        : mRenderer(renderer)
+        , mLanes(nullptr)
+        , mBackend(backend)
+    {
+    }
+
+    ~Worker()
+    {
+        delete mLanes;
+        delete mBackend;
+    }
+
+protected:
+    void run() override
+    {
+        /* shaped here, so the raw fonts of this worker's runs are its own */
+        mLanes = new LaneManager(&mGlyphAtlas, nullptr);
+        if (mRenderer->mSetup) {
+            mRenderer->mSetup(mLanes);
+        }
+
+        int frame = 0;
+        while (mRenderer->takeFrame(&frame)) {
+            mLanes->seek(frame / mRenderer->mFps);
+
+            /* in full mode the scene is complete after compose; present() would only repaint the hidden widget */
+            mBackend->beginScene();
+            mLanes->compose(mBackend);
+
+            QImage image(mBackend->frameSize(), QImage::Format_RGB32);
+            mBackend->readFrame(image.bits(), image.bytesPerLine());
+
+            if (mRenderer->mFormat == PngSequence) {
+                const bool saved = image.save(framePath(mRenderer->mPath, frame), "PNG");
+                mRenderer->finishFrame(frame, QByteArray(), saved);
+            } else {
+                mRenderer->finishFrame(frame, toYuv420(image), true);
+            }
+        }
+    }
+
+private:
+    OfflineRenderer *mRenderer;
+    GlyphAtlas mGlyphAtlas;
+    LaneManager *mLanes;
+    RasterRenderWidget *mBackend;
+};
+
+OfflineRenderer::OfflineRenderer()
+    : mFps(60.0)
+    , mDuration(10.0)
+    , mThreadCount(0)
+    , mFormat(PngSequence)
+    , mFrameCount(0)
+    , mNextFrame(0)
+    , mWritten(0)
+    , mWindow(0)
+    , mFailed(false)
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+int OfflineRenderer::frameCount() const
+{
+    return qRound(mDuration * mFps);
+}
+
+OfflineRenderer::Format OfflineRenderer::formatOf(const QString &path)
+{
+    return path.endsWith(".y4m", Qt::CaseInsensitive) ? Y4m : PngSequence;
+}
+
+QString OfflineRenderer::framePath(const QString &path, const int frame)
+{
+    const QString base = path.endsWith(".png", Qt::CaseInsensitive) ? path.left(path.size() - 4) : path;
+    return QString("%1%2.png").arg(base).arg(frame, 5, 10, QChar('0'));
+}
+
+bool OfflineRenderer::render(const QString &path)
+{
+    mPath = path;
+    mFormat = formatOf(path);
+    mFrameCount = frameCount();
+    mNextFrame = mWritten = 0;
+    mResults.clear();
+    mFailed = false;
+
+    const int threads = (mThreadCount > 0) ? mThreadCount : qMax(1, QThread::idealThreadCount());
+    mWindow = threads * 2;
+
+    /* the lanes only give the frame size here; every worker builds its own */
+    QSize size;
+    {
+        GlyphAtlas atlas;
+        LaneManager lanes(&atlas, nullptr);
+        if (mSetup) {
+            mSetup(&lanes);
+        }
+        size = lanes.size();
+    }
+
+    /* widgets are made on this thread; the workers only render into them */
+    QVector<Worker *> workers;
+    for (int i = 0; i < threads; ++i) {
+        RasterRenderWidget *backend = new RasterRenderWidget();
+        backend->resize(size);
+        backend->init();
+        workers.append(new Worker(this, backend));
+    }
+    if (size.isEmpty()) {
+        qWarning() << "[OfflineRenderer::render] - nothing to render, the lanes are empty";
+        qDeleteAll(workers);
+        return false;
+    }
+
+    QFile file;
+    if (mFormat == Y4m) {
+        file.setFileName(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "[OfflineRenderer::render] - cannot write" << path << file.errorString();
+            qDeleteAll(workers);
+            return false;
+        }
+        file.write(y4mHeader(size, mFps));
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    for (Worker *worker : workers) {
+        worker->start();
+    }
+
+    /* Y4M frames go out in order; PNG frames are already on disk and only counted */
+    QMutexLocker locker(&mMutex);
+    while (mWritten < mFrameCount && !mFailed) {
+        while (!mResults.contains(mWritten) && !mFailed) {
+            mChanged.wait(&mMutex);
+        }
+        if (mFailed) {
+            break;
+        }
+        const QByteArray data = mResults.take(mWritten);
+        locker.unlock();
+        if (mFormat == Y4m) {
+            const bool written = file.write("FRAME\n") == 6 && file.write(data) == data.size();
+            if (!written) {
+                qWarning() << "[OfflineRenderer::render] - cannot write" << path << file.errorString();
+            }
+            locker.relock();
+            mFailed = mFailed || !written;
+        } else {
+            locker.relock();
+        }
+        ++mWritten;
+        mChanged.wakeAll();
+    }
+    mFailed = mFailed || mWritten < mFrameCount;
+    mChanged.wakeAll();
+    locker.unlock();
+
+    for (Worker *worker : workers) {
+        worker->wait();
+    }
+    qDeleteAll(workers);
+
+    const double seconds = clock.nsecsElapsed() / 1e9;
+    qDebug() << "[OfflineRenderer::render] -" << mWritten << "frames of" << size << "in" << seconds << "s,"
+             << (seconds > 0 ? mWritten / seconds : 0.0) << "fps on" << threads << "threads";
+    return !mFailed;
+}
+
+bool OfflineRenderer::takeFrame(int *frame)
+{
+    QMutexLocker locker(&mMutex);
+    while (!mFailed && mNextFrame < mFrameCount && mNextFrame >= mWritten + mWindow) {
+        mChanged.wait(&mMutex);
+    }
+    if (mFailed || mNextFrame >= mFrameCount) {
+        return false;
+    }
+    *frame = mNextFrame++;
+    return true;
+}
+
+void OfflineRenderer::finishFrame(const int frame, const QByteArray &data, const bool ok)
+{
+    QMutexLocker locker(&mMutex);
+    if (!ok) {
+        qWarning() << "[OfflineRenderer::finishFrame] - cannot write frame" << frame;
+        mFailed = true;
+    }
+    mResults.insert(frame, data);
+    mChanged.wakeAll();
+}
+
+QByteArray OfflineRenderer::y4mHeader(const QSize &size, const double fps)
+{
+    /* the rate as an exact fraction where possible */
+    const qint64 milli = qRound64(fps * 1000);
+    const QByteArray rate = (milli % 1000 == 0)
+        ? QByteArray::number(milli / 1000) + ":1"
+        : QByteArray::number(milli) + ":1000";
+    return "YUV4MPEG2 W" + QByteArray::number(size.width()) + " H" + QByteArray::number(size.height())
+        + " F" + rate + " Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+}
+
+QByteArray OfflineRenderer::toYuv420(const QImage &frame)
+{
+    const int width = frame.width();
+    const int height = frame.height();
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+
+    QByteArray data(width * height + 2 * chromaWidth * chromaHeight, Qt::Uninitialized);
+    uchar *y = reinterpret_cast<uchar *>(data.data());
+    uchar *u = y + width * height;
+    uchar *v = u + chromaWidth * chromaHeight;
+
+    /* BT.709 limited range in 8-bit fixed point; integer only, so every run matches */
+    for (int row = 0; row < height; ++row) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(frame.constScanLine(row));
+        for (int x = 0; x < width; ++x) {
+            const int r = qRed(line[x]), g = qGreen(line[x]), b = qBlue(line[x]);
+            y[row * width + x] = uchar(((47 * r + 157 * g + 16 * b + 128) >> 8) + 16);
+        }
+    }
+
+    /* chroma of each 2x2 block from its average colour; odd edges reuse the last row / column */
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        const QRgb *top = reinterpret_cast<const QRgb *>(frame.constScanLine(cy * 2));
+        const QRgb *bottom = reinterpret_cast<const QRgb *>(frame.constScanLine(qMin(cy * 2 + 1, height - 1)));
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            const int x0 = cx * 2;
+            const int x1 = qMin(x0 + 1, width - 1);
+            const QRgb p[4] = { top[x0], top[x1], bottom[x0], bottom[x1] };
+            int r = 2, g = 2, b = 2;
+            for (const QRgb c : p) {
+                r += qRed(c);
+                g += qGreen(c);
+                b += qBlue(c);
+            }
+            r >>= 2;
+            g >>= 2;
+            b >>= 2;
+
+            /* the +128 << 8 offset keeps the shift non-negative and centres the chroma */
+            u[cy * chromaWidth + cx] = uchar((-26 * r - 86 * g + 112 * b + 128 + (128 << 8)) >> 8);
+            v[cy * chromaWidth + cx] = uchar((112 * r - 102 * g - 10 * b + 128 + (128 << 8)) >> 8);
+        }
+    }
+    return data;
+}
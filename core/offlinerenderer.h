@@ -0,0 +1,101 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+class LaneManager;
+
+/*
+ * Renders a fixed duration of the ticker to a PNG sequence or a Y4M file as
+ * fast as the cores allow.
+ *
+ * Every frame is rendered from scratch at its scene time (LaneManager::seek)
+ * with synchronous rasterization, so a frame does not depend on which worker
+ * renders it or what that worker rendered before: the output is bit-identical
+ * between runs and thread counts. Workers take frames in order; PNG frames are
+ * encoded by the workers, Y4M frames are converted by the workers and written
+ * in order by the calling thread.
+ *
+ * Shaped text holds QRawFonts, which belong to the thread that made them, so
+ * every worker builds its lanes and glyph atlas on its own thread and shapes
+ * and rasterizes there; nothing font related is shared between workers.
+ */
+class OfflineRenderer
+{
+public:
+    enum Format { PngSequence, Y4m };
+
+    OfflineRenderer();
+    ~OfflineRenderer();
+
+    /* builds the lanes of one worker on its thread; also once on the calling thread for the frame size */
+    void setSetup(const std::function<void(LaneManager *)> &setup) {
+        mSetup = setup;
+    }
+    void setFrameRate(const double fps) {
+        mFps = qMax(1.0, fps);
+    }
+    void setDuration(const double seconds) {
+        mDuration = qMax(0.0, seconds);
+    }
+    /* 0 uses every core */
+    void setThreadCount(const int threads) {
+        mThreadCount = threads;
+    }
+
+    int frameCount() const;
+
+    /*
+     * "<name>.y4m" writes one Y4M file (4:2:0, BT.709 limited range);
+     * "<name>.png" writes <name>00000.png, <name>00001.png, ...
+     * Blocks until every frame is written.
+     */
+    bool render(const QString &path);
+
+    static Format formatOf(const QString &path);
+    static QString framePath(const QString &path, const int frame);
+
+private:
+    class Worker;
+
+    /* 4:2:0 planes of an opaque BGRA frame */
+    static QByteArray toYuv420(const QImage &frame);
+    static QByteArray y4mHeader(const QSize &size, const double fps);
+
+    bool takeFrame(int *frame);
+    void finishFrame(const int frame, const QByteArray &data, const bool ok);
+
+    std::function<void(LaneManager *)> mSetup;
+    double mFps;
+    double mDuration;
+    int mThreadCount;
+
+    Format mFormat;
+    QString mPath;
+    int mFrameCount;
+
+    /* frames are handed out in order and at most a window ahead of the writer */
+    QMutex mMutex;
+    QWaitCondition mChanged;
+    int mNextFrame;
+    int mWritten;
+    int mWindow;
+    QMap<int, QByteArray> mResults;
+    bool mFailed;
+};
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "pixelbufferpool.h"
+
+#include <QMutexLocker>
+#include <QtGlobal>
+
+#include <new>
+
+namespace {
+/* the pixels start a cache line after the block header */
+const int HeaderSize = 64;
+}
+
+struct PixelBufferPool::Block
+{
+    PixelBufferPool *pool;
+    qint64 bytes;       // class size of the pixels
+
+    uchar *pixels() { return reinterpret_cast<uchar *>(this) + HeaderSize; }
+};
+
+PixelBufferPool::PixelBufferPool(const qint64 budgetBytes)
+    : mBudget(budgetBytes)
+    , mHits(0)
+    , mMisses(0)
+    , mInUseBytes(0)
+    , mFreeBytes(0)
+    , mPeakBytes(0)
+{
+}
+
+PixelBufferPool::~PixelBufferPool()
+{
+    shrinkTo(0);
+}
+
+PixelBufferPool *PixelBufferPool::global()
+{
+    static PixelBufferPool *pool = new PixelBufferPool();
+    return pool;
+}
+
+qint64 PixelBufferPool::classSize(const qint64 bytes)
+{
+    /* 4 KiB minimum, then four classes per power of two */
+    const qint64 size = qMax<qint64>(4096, bytes);
+    qint64 octave = 4096;
+    while (octave * 2 <= size) {
+        octave *= 2;
+    }
+    const qint64 step = octave / 4;
+    return (size + step - 1) / step * step;
+}
+
+QImage PixelBufferPool::acquire(const QSize &size, const QImage::Format format)
+{
+    if (size.isEmpty()) {
+        return QImage();
+    }
+
+    /* the same 32-bit aligned rows QImage(size, format) would have */
+    const int bytesPerLine = ((size.width() * QImage::toPixelFormat(format).bitsPerPixel() + 31) >> 5) << 2;
+    const qint64 bytes = classSize(qint64(bytesPerLine) * size.height());
+
+    Block *block = nullptr;
+    {
+        QMutexLocker locker(&mMutex);
+        QVector<Block *> &free = mFree[bytes];
+        if (!free.isEmpty()) {
+            block = free.takeLast();
+            mFreeBytes -= bytes;
+            ++mHits;
+        } else {
+            ++mMisses;
+        }
+        mInUseBytes += bytes;
+        mPeakBytes = qMax(mPeakBytes, mInUseBytes + mFreeBytes);
+    }
+
+    if (block == nullptr) {
+        void *memory = qMallocAligned(size_t(HeaderSize + bytes), HeaderSize);
+        if (memory == nullptr) {
+            QMutexLocker locker(&mMutex);
+            mInUseBytes -= bytes;
+            return QImage(size, format);
+        }
+        block = new (memory) Block;
+        block->pool = this;
+        block->bytes = bytes;
+    }
+    return QImage(block->pixels(), size.width(), size.height(), bytesPerLine, format,
+                  &PixelBufferPool::release, block);
+}
+
+void PixelBufferPool::release(void *info)
+{
+    Block *block = static_cast<Block *>(info);
+    block->pool->recycle(block);
+}
+
+void PixelBufferPool::recycle(Block *block)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mInUseBytes -= block->bytes;
+        if (mFreeBytes + block->bytes <= mBudget) {
+            mFree[block->bytes].append(block);
+            mFreeBytes += block->bytes;
+            return;
+        }
+    }
+    qFreeAligned(block);
+}
+
+void PixelBufferPool::setBudget(const qint64 bytes)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mBudget = qMax<qint64>(0, bytes);
+    }
+    shrinkTo(bytes);
+}
+
+void PixelBufferPool::trim()
+{
+    shrinkTo(0);
+}
+
+void PixelBufferPool::shrinkTo(const qint64 bytes)
+{
+    /* unlink under the lock, free outside it */
+    QVector<Block *> released;
+    {
+        QMutexLocker locker(&mMutex);
+        for (QHash<qint64, QVector<Block *>>::iterator it = mFree.begin();
+             it != mFree.end() && mFreeBytes > bytes; ++it) {
+            while (!it.value().isEmpty() && mFreeBytes > bytes) {
+                released.append(it.value().takeLast());
+                mFreeBytes -= it.key();
+            }
+        }
+    }
+    for (Block *block : released) {
+        qFreeAligned(block);
+    }
+}
+
+PixelBufferPool::Stats PixelBufferPool::stats() const
+{
+    QMutexLocker locker(&mMutex);
+    Stats stats;
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.inUseBytes = mInUseBytes;
+    stats.freeBytes = mFreeBytes;
+    stats.peakBytes = mPeakBytes;
+    return stats;
+}
+
+double PixelBufferPool::hitRate() const
+{
+    const Stats s = stats();
+    return (s.hits + s.misses) ? double(s.hits) / double(s.hits + s.misses) : 0.0;
+}
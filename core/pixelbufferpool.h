@@ -0,0 +1,73 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef PIXELBUFFERPOOL_H
+#define PIXELBUFFERPOOL_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QVector>
+
+/*
+ * Recycled pixel memory for strip images, tiles and board segments.
+ *
+ * acquire() returns a QImage built directly on a pooled buffer (no copy);
+ * when the last copy of that image goes away, on whatever thread, the buffer
+ * returns to the free list of its size class instead of to the heap. Size
+ * classes are four steps per power of two, so a buffer is at most a quarter
+ * larger than asked for and same-sized tiles always reuse each other's memory.
+ * Free buffers beyond the budget are released. Thread-safe.
+ */
+class PixelBufferPool
+{
+public:
+    struct Stats
+    {
+        quint64 hits;           // acquires served from a free buffer
+        quint64 misses;         // acquires that allocated
+        qint64 inUseBytes;      // buffers held by live images
+        qint64 freeBytes;       // buffers waiting for reuse
+        qint64 peakBytes;       // highest inUseBytes + freeBytes seen
+    };
+
+    explicit PixelBufferPool(const qint64 budgetBytes = 64 << 20);
+    ~PixelBufferPool();
+
+    /* shared by every strip, board and image creator; never destroyed, images may outlive main() */
+    static PixelBufferPool *global();
+
+    /* uninitialized pixels, the default bytes per line of the format */
+    QImage acquire(const QSize &size, const QImage::Format format);
+
+    /* bytes of free buffers kept for reuse */
+    void setBudget(const qint64 bytes);
+    void trim();
+
+    Stats stats() const;
+    double hitRate() const;
+
+    static qint64 classSize(const qint64 bytes);
+
+private:
+    struct Block;
+
+    static void release(void *info);
+    void recycle(Block *block);
+    void shrinkTo(const qint64 bytes);
+
+    mutable QMutex mMutex;
+    QHash<qint64, QVector<Block *>> mFree;
+    qint64 mBudget;
+
+    quint64 mHits;
+    quint64 mMisses;
+    qint64 mInUseBytes;
+    qint64 mFreeBytes;
+    qint64 mPeakBytes;
+};
+
+#endif
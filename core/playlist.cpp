@@ -0,0 +1,206 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "playlist.h"
+#include "shapedtextcache.h"
+#include "tiledstrip.h"
+
+#include <QtMath>
+
+#include <algorithm>
+
+Playlist::Playlist(GlyphAtlas *atlas)
+    : mGlyphAtlas(atlas)
+    , mThreadPool(nullptr)
+    , mColor(Qt::black)
+    , mHeight(0)
+    , mGap(200)
+    , mLookahead(2)
+    , mPhases(1)
+    , mRetiredDrops(0)
+{
+}
+
+Playlist::~Playlist()
+{
+    reset();
+}
+
+void Playlist::setItems(const QStringList &items)
+{
+    reset();
+    mTexts = items;
+    mWidths.clear();
+    mStarts.clear();
+}
+
+void Playlist::setGap(const int pixels)
+{
+    /* strips stay valid, only the chain moves */
+    mGap = qMax(0, pixels);
+    mWidths.clear();
+    mStarts.clear();
+}
+
+void Playlist::setPhases(const int phases)
+{
+    mPhases = phases;
+    for (TiledStrip *item : mLive) {
+        item->setPhases(phases);
+    }
+}
+
+void Playlist::setStyle(const QFont &font, const QColor &color, const int height)
+{
+    reset();
+    mFont = font;
+    mColor = color;
+    mHeight = height;
+    mWidths.clear();
+    mStarts.clear();
+}
+
+void Playlist::measureTo(const double travel)
+{
+    /* until the next unmeasured item would start beyond travel */
+    while (mStarts.size() < mTexts.size()) {
+        const double next = mStarts.isEmpty() ? 0.0 : mStarts.last() + mWidths.last() + mGap;
+        if (!mStarts.isEmpty() && next > travel) {
+            break;
+        }
+        const ShapedTextCache::Entry shaped = ShapedTextCache::global()->shape(mTexts.at(mStarts.size()), mFont);
+        mWidths.append(shaped->valid ? qCeil(shaped->width) : 0);
+        mStarts.append(next);
+    }
+}
+
+double Playlist::period() const
+{
+    if (mTexts.isEmpty() || mStarts.size() < mTexts.size()) {
+        return -1.0;
+    }
+    return mStarts.last() + mWidths.last() + mGap;
+}
+
+double Playlist::wrap(const double travel)
+{
+    if (travel <= 0.0) {
+        return travel;
+    }
+    measureTo(travel);
+    const double loop = period();
+    return (loop > 0.0 && travel >= loop) ? travel - loop * qFloor(travel / loop) : travel;
+}
+
+void Playlist::compose(SceneTarget *target, const double travel, const int top, const int viewWidth, const bool leftToRight)
+{
+    if (mTexts.isEmpty() || mHeight <= 0 || viewWidth <= 0) {
+        reset();
+        return;
+    }
+
+    /* nothing comes before the first item of the first loop */
+    const double begin = qMax(0.0, travel);
+    const double end = travel + viewWidth;
+    const int count = mTexts.size();
+
+    measureTo(begin);
+    const double loopLength = period();
+    qint64 loop = (loopLength > 0.0) ? qint64(qFloor(begin / loopLength)) : 0;
+    const double local = begin - (loopLength > 0.0 ? loop * loopLength : 0.0);
+    int k = int(std::upper_bound(mStarts.constBegin(), mStarts.constEnd(), local) - mStarts.constBegin()) - 1;
+    k = qMax(0, k);
+
+    QMap<qint64, TiledStrip *> live;
+    int ahead = 0;
+    const int maxSteps = 2 * count + viewWidth + mLookahead;
+    for (int step = 0; step < maxSteps; ++step, ++k) {
+        if (k == count) {
+            if (loopLength <= 0.0) {
+                break;
+            }
+            k = 0;
+            ++loop;
+        }
+        if (k >= mStarts.size()) {
+            measureTo(mStarts.last() + mWidths.last() + mGap);
+        }
+
+        const double start = (loopLength > 0.0 ? loop * loopLength : 0.0) + mStarts.at(k);
+        const int width = mWidths.at(k);
+        const bool upcoming = start >= end;
+        if (upcoming && ahead >= mLookahead) {
+            break;
+        }
+        if (upcoming) {
+            ++ahead;
+        }
+        if (width <= 0 || start + width <= travel) {
+            continue;
+        }
+
+        const qint64 occurrence = loop * count + k;
+        TiledStrip *item = mLive.value(occurrence);
+        if (item == nullptr) {
+            item = new TiledStrip(mGlyphAtlas);
+            item->setThreadPool(mThreadPool);
+            item->setPhases(mPhases);
+            item->setText(mTexts.at(k), mFont, mColor, mHeight);
+        }
+        live.insert(occurrence, item);
+
+        if (upcoming) {
+            item->prefetch(leftToRight);
+        } else {
+            const double x = leftToRight ? travel + viewWidth - start - width : start - travel;
+            item->compose(target, QPointF(x, top), viewWidth, leftToRight);
+        }
+    }
+
+    /* items that left the window, or were skipped by a seek */
+    for (QMap<qint64, TiledStrip *>::const_iterator it = mLive.constBegin(); it != mLive.constEnd(); ++it) {
+        if (!live.contains(it.key())) {
+            mRetiredDrops += it.value()->droppedFrames();
+            delete it.value();
+        }
+    }
+    mLive = live;
+}
+
+void Playlist::reset()
+{
+    for (TiledStrip *item : mLive) {
+        mRetiredDrops += item->droppedFrames();
+    }
+    qDeleteAll(mLive);
+    mLive.clear();
+}
+
+int Playlist::pendingTiles() const
+{
+    int pending = 0;
+    for (const TiledStrip *item : mLive) {
+        pending += item->pendingTiles();
+    }
+    return pending;
+}
+
+qint64 Playlist::byteSize() const
+{
+    qint64 bytes = 0;
+    for (const TiledStrip *item : mLive) {
+        bytes += item->byteSize();
+    }
+    return bytes;
+}
+
+quint64 Playlist::droppedFrames() const
+{
+    quint64 dropped = mRetiredDrops;
+    for (const TiledStrip *item : mLive) {
+        dropped += item->droppedFrames();
+    }
+    return dropped;
+}
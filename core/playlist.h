@@ -0,0 +1,94 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <QColor>
+#include <QFont>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class GlyphAtlas;
+class SceneTarget;
+class TiledStrip;
+class QThreadPool;
+
+/*
+ * Messages chained back to back in one lane, a fixed gap apart, looping
+ * without a pause: after the last item and its gap comes the first again.
+ *
+ * Positions are distances along the chain ("travel"). Items are measured
+ * only when the chain reaches them, so a long playlist costs nothing up
+ * front. Only the items in the window and the next few after it have a
+ * TiledStrip; the upcoming ones get their leading tiles rasterized before
+ * they scroll in, and a strip is deleted as soon as its item has left.
+ */
+class Playlist
+{
+public:
+    explicit Playlist(GlyphAtlas *atlas);
+    ~Playlist();
+
+    void setThreadPool(QThreadPool *pool) {
+        mThreadPool = pool;
+    }
+
+    void setItems(const QStringList &items);
+    QStringList items() const { return mTexts; }
+    bool isEmpty() const { return mTexts.isEmpty(); }
+
+    /* pixels between the end of one item and the start of the next */
+    void setGap(const int pixels);
+    int gap() const { return mGap; }
+
+    /* items after the window whose first tiles are rasterized ahead */
+    void setLookahead(const int items) {
+        mLookahead = qMax(0, items);
+    }
+
+    /* sub-pixel phases of every strip, see TiledStrip::setPhases() */
+    void setPhases(const int phases);
+
+    void setStyle(const QFont &font, const QColor &color, const int height);
+
+    /* travel reduced to one loop; loops are only known once every item up to travel is measured */
+    double wrap(const double travel);
+
+    /* the window shows [travel, travel + viewWidth) of the chain, entering from the right or the left */
+    void compose(SceneTarget *target, const double travel, const int top, const int viewWidth, const bool leftToRight);
+
+    int liveItems() const { return mLive.size(); }
+    int pendingTiles() const;
+    qint64 byteSize() const;
+    quint64 droppedFrames() const;
+
+private:
+    void measureTo(const double travel);
+    double period() const;
+    void reset();
+
+    GlyphAtlas *mGlyphAtlas;
+    QThreadPool *mThreadPool;
+    QFont mFont;
+    QColor mColor;
+    int mHeight;
+    int mGap;
+    int mLookahead;
+    int mPhases;
+
+    QStringList mTexts;
+    /* widths and chain starts of the first mStarts.size() items */
+    QVector<int> mWidths;
+    QVector<double> mStarts;
+
+    /* strips by occurrence: loop * item count + item */
+    QMap<qint64, TiledStrip *> mLive;
+    quint64 mRetiredDrops;
+};
+
+#endif
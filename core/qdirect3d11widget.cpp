@@ -36,6 +36,7 @@
 #include <QDebug>
 #include <QEvent>
 #include <QWheelEvent>
+#include <QHBoxLayout>
 
 #if 0
 const int FPS_LIMIT    = 480.0f;
@@ -43,17 +44,15 @@ const int MS_PER_FRAME = (int)((1.0f / FPS_LIMIT) * 1000.0f);
 #endif
 
 QDirect3D11Widget::QDirect3D11Widget(QWidget * parent)
-    : QWidget(parent)
+    : RenderBackend(parent)
     , m_pDevice(Q_NULLPTR)
     , m_pDeviceContext(Q_NULLPTR)
     , m_pSwapChain(Q_NULLPTR)
     , m_pRTView(Q_NULLPTR)
     , m_hWnd(reinterpret_cast<HWND>(winId()))
-    , m_bDeviceInitialized(false)
-    , m_bRenderActive(false)
-    , m_bStarted(false)
-    , m_fpsLimit(60.0)
-    , m_msPerFrame(16)
+    , m_pOverlayScene(new QGraphicsScene(this))
+    , m_pOverlayView(new QGraphicsView(this))
+    , m_overlayFrame(0)
     //, m_BackColor{0.0f, 0.135f, 0.481f, 1.0f}
 {
     qDebug() << "[QDirect3D11Widget::QDirect3D11Widget] - Widget Handle: " << m_hWnd;
@@ -72,18 +71,31 @@ QDirect3D11Widget::QDirect3D11Widget(QWidget * parent)
     setAttribute(Qt::WA_NoSystemBackground);
 
     m_BackColor = { 0.0f, 0.135f, 0.481f, 1.0f };
+
+    m_pOverlayView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_pOverlayView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_pOverlayView->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    m_pOverlayView->setScene(m_pOverlayScene);
+
+    QHBoxLayout * layout = new QHBoxLayout(this);
+    layout->setSpacing(0);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_pOverlayView);
 }
 
 QDirect3D11Widget::~QDirect3D11Widget() 
 {
+    releaseUploads();
     qDebug() << "delete.";
 }
 
 void QDirect3D11Widget::release()
 {
     m_bDeviceInitialized = false;
-    disconnect(&m_qTimer, &QTimer::timeout, this, &QDirect3D11Widget::onFrame);
-    m_qTimer.stop();
+    m_pacer.stop();
+
+    // The textures belong to the device.
+    releaseUploads();
 
     ReleaseObject(m_pRTView);
     ReleaseObject(m_pSwapChain);
@@ -91,48 +103,6 @@ void QDirect3D11Widget::release()
     ReleaseObject(m_pDevice);
 }
 
-void QDirect3D11Widget::run()
-{
-    m_qTimer.start(m_msPerFrame);
-    m_bRenderActive = m_bStarted = true;
-}
-
-void QDirect3D11Widget::pauseFrames()
-{
-    if (!m_qTimer.isActive() || !m_bStarted) return;
-
-    disconnect(&m_qTimer, &QTimer::timeout, this, &QDirect3D11Widget::onFrame);
-    m_qTimer.stop();
-    m_bRenderActive = false;
-}
-
-void QDirect3D11Widget::continueFrames()
-{
-    if (m_qTimer.isActive() || !m_bStarted) return;
-
-    connect(&m_qTimer, &QTimer::timeout, this, &QDirect3D11Widget::onFrame);
-    m_qTimer.start(m_msPerFrame);
-    m_bRenderActive = true;
-}
-
-void QDirect3D11Widget::resetFrameRate(const double fps)
-{
-    m_fpsLimit = fps;
-    m_msPerFrame = (int)((1.0f / m_fpsLimit) * 1000.0f);
-    m_qTimer.start(m_msPerFrame);
-}
-
-void QDirect3D11Widget::showEvent(QShowEvent * event)
-{
-    if (!m_bDeviceInitialized)
-    {
-        m_bDeviceInitialized = init();
-        emit deviceInitialized(m_bDeviceInitialized);
-    }
-
-    QWidget::showEvent(event);
-}
-
 bool QDirect3D11Widget::init()
 {
     DXGI_SWAP_CHAIN_DESC sd               = {};
@@ -172,19 +142,9 @@ bool QDirect3D11Widget::init()
 
     resetEnvironment();
 
-    connect(&m_qTimer, &QTimer::timeout, this, &QDirect3D11Widget::onFrame);
-
     return true;
 }
 
-void QDirect3D11Widget::onFrame()
-{
-    if (m_bRenderActive) tick();
-    beginScene();
-    render();
-    endScene();
-}
-
 void QDirect3D11Widget::beginScene()
 {
     // _[^[Qbgo̓^[QbgƂĎw肷
@@ -192,33 +152,83 @@ void QDirect3D11Widget::beginScene()
     // _[^[QbgNAĒPFɂ
     m_pDeviceContext->ClearRenderTargetView(m_pRTView,
                                             reinterpret_cast<const float *>(&m_BackColor));
+
+    ++m_overlayFrame;
 }
 
-void QDirect3D11Widget::endScene()
+UploadManager * QDirect3D11Widget::createUploadManager()
 {
-    /* _Oꂽ摜EBhE֕\
-     * Present͍̓sȂ悤ɕύX
-     * Ƒx邽
-     */
-    if (FAILED(m_pSwapChain->Present(0, 0))) { onReset(); }
+    return new D3D11UploadManager(m_pDevice, m_pDeviceContext);
 }
 
-void QDirect3D11Widget::tick()
+void QDirect3D11Widget::compose(const QImage & image, const QPointF & pos)
 {
-    // TODO: Update your scene here. For aesthetics reasons, only do it here if it's an
-    // important component, otherwise do it in the MainWindow.
-    // m_pCamera->Tick();
+    uploadImage(image);
+
+    const qint64 key = image.cacheKey();
 
-    emit ticked();
+    // Reuse the item already showing this image, unless it was placed this frame.
+    OverlayImageItem * item = Q_NULLPTR;
+    for (QMultiHash<qint64, OverlayImageItem *>::iterator it = m_overlayItems.find(key);
+         it != m_overlayItems.end() && it.key() == key; ++it)
+    {
+        if (it.value()->data(0).toInt() != m_overlayFrame)
+        {
+            item = it.value();
+            break;
+        }
+    }
+
+    // Only take the image when the content is new to the overlay; it is shared, not copied.
+    if (item == Q_NULLPTR)
+    {
+        if (m_overlaySpare.isEmpty())
+        {
+            item = new OverlayImageItem();
+            m_pOverlayScene->addItem(item);
+        }
+        else
+        {
+            item = m_overlaySpare.takeLast();
+        }
+        item->setImage(image);
+        m_overlayItems.insert(key, item);
+    }
+
+    item->setData(0, m_overlayFrame);
+    item->setPos(pos);
+    item->setVisible(true);
 }
 
-void QDirect3D11Widget::render()
+void QDirect3D11Widget::present()
 {
-    // TODO: Present your scene here. For aesthetics reasons, only do it here if it's an
-    // important component, otherwise do it in the MainWindow.
-    // m_pCamera->Apply();
+    /* _Oꂽ摜EBhE֕\
+     * Present͍̓sȂ悤ɕύX
+     * Ƒx邽
+     * vsyncw莞 (ȓd̓vt@C) ̂ݕ\Ԋuɓ
+     */
+    const UINT syncInterval = m_bVSync ? 1 : 0;
+    if (FAILED(m_pSwapChain->Present(syncInterval, 0))) { onReset(); }
 
-    emit rendered();
+    QMultiHash<qint64, OverlayImageItem *>::iterator it = m_overlayItems.begin();
+    while (it != m_overlayItems.end())
+    {
+        if (it.value()->data(0).toInt() == m_overlayFrame)
+        {
+            ++it;
+            continue;
+        }
+        it.value()->setVisible(false);
+        it.value()->setImage(QImage());
+        m_overlaySpare.append(it.value());
+        it = m_overlayItems.erase(it);
+    }
+}
+
+void QDirect3D11Widget::resizeBuffers(const QSize & size)
+{
+    m_pOverlayScene->setSceneRect(0, 0, size.width(), size.height());
+    onReset();
 }
 
 void QDirect3D11Widget::onReset()
@@ -236,9 +246,9 @@ void QDirect3D11Widget::resetEnvironment()
     // TODO: Add your own custom default environment, i.e:
     // m_pCamera->resetCamera();
 
-    onReset();
+    resizeBuffers(size());
 
-    if (!m_bRenderActive) tick();
+    if (!m_bRenderActive) emit ticked();
 }
 
 void QDirect3D11Widget::wheelEvent(QWheelEvent * event)
@@ -267,17 +277,6 @@ QPaintEngine * QDirect3D11Widget::paintEngine() const
 
 void QDirect3D11Widget::paintEvent(QPaintEvent * event) {}
 
-void QDirect3D11Widget::resizeEvent(QResizeEvent * event)
-{
-    if (m_bDeviceInitialized)
-    {
-        onReset();
-        emit widgetResized();
-    }
-
-    QWidget::resizeEvent(event);
-}
-
 bool QDirect3D11Widget::event(QEvent * event)
 {
     switch (event->type())
@@ -359,3 +358,111 @@ bool QDirect3D11Widget::winEvent(MSG * message, long * result)
     return QWidget::winEvent(message, result);
 }
 #endif // QT_VERSION >= 0x050000
+
+// ############################################################################
+// ########################### D3D11UploadManager ############################
+// ############################################################################
+D3D11UploadManager::D3D11UploadManager(ID3D11Device * device, ID3D11DeviceContext * context, const int ringSize)
+    : UploadManager(RGBA8, ringSize)
+    , m_pDevice(device)
+    , m_pDeviceContext(context)
+    , m_staging(qMax(1, ringSize), Q_NULLPTR)
+    , m_stagingSize(qMax(1, ringSize))
+{
+}
+
+D3D11UploadManager::~D3D11UploadManager()
+{
+    clear();
+    for (ID3D11Texture2D * staging : m_staging)
+    {
+        if (staging != Q_NULLPTR) staging->Release();
+    }
+}
+
+int D3D11UploadManager::createTexture(const QSize & size)
+{
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width                = UINT(size.width());
+    desc.Height               = UINT(size.height());
+    desc.MipLevels            = 1;
+    desc.ArraySize            = 1;
+    desc.Format               = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count     = 1;
+    desc.Usage                = D3D11_USAGE_DEFAULT;
+    desc.BindFlags            = D3D11_BIND_SHADER_RESOURCE;
+
+    ID3D11Texture2D * texture = Q_NULLPTR;
+    if (FAILED(m_pDevice->CreateTexture2D(&desc, NULL, &texture)))
+    {
+        qWarning() << "[D3D11UploadManager::createTexture] - cannot create" << size;
+        return -1;
+    }
+
+    if (!m_freeTextures.isEmpty())
+    {
+        const int index = m_freeTextures.takeLast();
+        m_textures[index] = texture;
+        return index;
+    }
+    m_textures.append(texture);
+    return m_textures.size() - 1;
+}
+
+void D3D11UploadManager::releaseTexture(const int texture)
+{
+    ReleaseObject(m_textures[texture]);
+    m_freeTextures.append(texture);
+}
+
+UploadManager::Staging D3D11UploadManager::mapStaging(const int slot, const QSize & size)
+{
+    Staging result = { Q_NULLPTR, 0 };
+
+    // Staging textures only grow, so the ring stops allocating once it holds the largest upload.
+    const QSize current = m_stagingSize.at(slot);
+    if (m_staging.at(slot) == Q_NULLPTR || current.width() < size.width() || current.height() < size.height())
+    {
+        ReleaseObject(m_staging[slot]);
+        const QSize grown = size.expandedTo(current);
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width                = UINT(grown.width());
+        desc.Height               = UINT(grown.height());
+        desc.MipLevels            = 1;
+        desc.ArraySize            = 1;
+        desc.Format               = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count     = 1;
+        desc.Usage                = D3D11_USAGE_STAGING;
+        desc.CPUAccessFlags       = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(m_pDevice->CreateTexture2D(&desc, NULL, &m_staging[slot])))
+        {
+            qWarning() << "[D3D11UploadManager::mapStaging] - cannot create staging" << grown;
+            m_stagingSize[slot] = QSize();
+            return result;
+        }
+        m_stagingSize[slot] = grown;
+    }
+
+    // Waits only if the GPU still copies from this slot, i.e. the ring wrapped within a frame.
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    if (FAILED(m_pDeviceContext->Map(m_staging.at(slot), 0, D3D11_MAP_WRITE, 0, &mapped)))
+    {
+        return result;
+    }
+    result.bits         = static_cast<uchar *>(mapped.pData);
+    result.bytesPerLine = int(mapped.RowPitch);
+    return result;
+}
+
+void D3D11UploadManager::copyStaging(const int slot, const int texture, const QRect & rect)
+{
+    m_pDeviceContext->Unmap(m_staging.at(slot), 0);
+
+    D3D11_BOX box = {};
+    box.right     = UINT(rect.width());
+    box.bottom    = UINT(rect.height());
+    box.back      = 1;
+    m_pDeviceContext->CopySubresourceRegion(m_textures.at(texture), 0, UINT(rect.x()), UINT(rect.y()), 0,
+                                            m_staging.at(slot), 0, &box);
+}
@@ -35,12 +35,68 @@
 #include <stdexcept>
 
 #include <QWidget>
-#include <QTimer>
+#include <QVector>
+#include <QMultiHash>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QGraphicsItem>
+#include <QPainter>
 
 #include <d3d11.h>
 #include <D3Dcompiler.h>
 
-class QDirect3D11Widget : public QWidget
+#include "renderbackend.h"
+
+// Shows a QImage as it is: unlike QGraphicsPixmapItem there is no image to
+// pixmap conversion, so a pooled tile buffer is shared instead of copied.
+class OverlayImageItem : public QGraphicsItem
+{
+public:
+    void setImage(const QImage & image)
+    {
+        prepareGeometryChange();
+        m_image = image;
+    }
+
+    QRectF boundingRect() const override { return QRectF(QPointF(0, 0), m_image.size()); }
+
+    void paint(QPainter * painter, const QStyleOptionGraphicsItem *, QWidget *) override
+    {
+        painter->drawImage(0, 0, m_image);
+    }
+
+private:
+    QImage m_image;
+};
+
+// Textures in the swap chain format (R8G8B8A8_UNORM, premultiplied) for the
+// images the widget composes. Rows are written into a ring of persistent
+// CPU-writable staging textures and copied on the GPU, so an upload creates
+// no resource and a staging texture is only refilled after the ring wraps.
+class D3D11UploadManager : public UploadManager
+{
+public:
+    D3D11UploadManager(ID3D11Device * device, ID3D11DeviceContext * context, const int ringSize = 3);
+    ~D3D11UploadManager();
+
+    ID3D11Texture2D * texture(const int texture) const { return m_textures.at(texture); }
+
+protected:
+    int     createTexture(const QSize & size) override;
+    void    releaseTexture(const int texture) override;
+    Staging mapStaging(const int slot, const QSize & size) override;
+    void    copyStaging(const int slot, const int texture, const QRect & rect) override;
+
+private:
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pDeviceContext;
+    QVector<ID3D11Texture2D *>  m_textures;
+    QVector<int>                m_freeTextures;
+    QVector<ID3D11Texture2D *>  m_staging;
+    QVector<QSize>              m_stagingSize;
+};
+
+class QDirect3D11Widget : public RenderBackend
 {
     Q_OBJECT
 
@@ -51,28 +107,23 @@ public:
     void release();
     void resetEnvironment();
 
-    void run();
-    void pauseFrames();
-    void continueFrames();
-
-    void resetFrameRate(const double fps);
-
-private:
-    bool init();
-
-    void beginScene();
-    void endScene();
+    // RenderBackend
+public:
+    bool init() override;
+    void beginScene() override;
+    void compose(const QImage & image, const QPointF & pos) override;
+    void present() override;
+    void resizeBuffers(const QSize & size) override;
+    bool supportsVSync() const override { return true; }
 
-    void tick();
-    void render();
+protected:
+    UploadManager * createUploadManager() override;
 
     // Qt Events
 private:
     bool           event(QEvent * event) override;
-    void           showEvent(QShowEvent * event) override;
     QPaintEngine * paintEngine() const override;
     void           paintEvent(QPaintEvent * event) override;
-    void           resizeEvent(QResizeEvent * event) override;
     void           wheelEvent(QWheelEvent * event) override;
 
     LRESULT WINAPI WndProc(MSG * pMsg);
@@ -84,13 +135,7 @@ private:
 #endif
 
 signals:
-    void deviceInitialized(bool success);
-
     void eventHandled();
-    void widgetResized();
-
-    void ticked();
-    void rendered();
 
     void keyPressed(QKeyEvent *);
     void mouseMoved(QMouseEvent *);
@@ -98,7 +143,6 @@ signals:
     void mouseReleased(QMouseEvent *);
 
 private slots:
-    void onFrame();
     void onReset();
 
     // Getters / Setters
@@ -110,9 +154,6 @@ public:
     IDXGISwapChain *         swapChain() { return m_pSwapChain; }
     ID3D11RenderTargetView * TargetView() const { return m_pRTView; }
 
-    bool renderActive() const { return m_bRenderActive; }
-    void setRenderActive(bool active) { m_bRenderActive = active; }
-
     D3DCOLORVALUE * BackColor() { return &m_BackColor; }
 
 private:
@@ -121,16 +162,16 @@ private:
     IDXGISwapChain *         m_pSwapChain;
     ID3D11RenderTargetView * m_pRTView;
 
-    QTimer m_qTimer;
-
     HWND m_hWnd;
-    bool m_bDeviceInitialized;
-
-    bool m_bRenderActive;
-    bool m_bStarted;
 
-    double m_fpsLimit;
-    int m_msPerFrame;
+    // Strips are still drawn by a QGraphicsView overlaid on the swap chain.
+    // Items are keyed by QImage::cacheKey() so a tile keeps its item while it
+    // scrolls; items not composed in a frame are hidden and recycled.
+    QGraphicsScene *                                m_pOverlayScene;
+    QGraphicsView *                                 m_pOverlayView;
+    QMultiHash<qint64, OverlayImageItem *>          m_overlayItems;
+    QVector<OverlayImageItem *>                     m_overlaySpare;
+    int                                             m_overlayFrame;
 
     D3DCOLORVALUE m_BackColor;
 };
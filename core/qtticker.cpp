@@ -4,90 +4,64 @@
  */
 
 #include "qtticker.h"
-#include "stringimagecreater.h"
+#include "metricsserver.h"
+#include "rasterrenderwidget.h"
 
 #include <QString>
-#include <QFont>
-#include <QFontMetrics>
 #include <QMessageBox>
-#include <QPixmap>
-#include <QGraphicsPixmapItem>
-#include <QGraphicsView>
+#include <QDebug>
+#include <QtMath>
 
-QtTicker::QtTicker(QWidget *parent)
+QtTicker::QtTicker(const QString &backendName, TickerEngine *engine, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::QtTickerClass)
-    , mWindowSize(1920, 90)
-    , mMovingAmount(0.0)
-    , mScrollPos(0.0)
-    , mGraphicsScene(new QGraphicsScene(this))
+    , mEngine(engine)
+    , mOwnsEngine(engine == Q_NULLPTR)
 {
     ui->setupUi(this);
-    mDx11Scene = ui->view;
 
-    /* init moving amount */
-    mMovingAmount = 0.4;
+    /* create render backend */
+    mBackend = RenderBackend::create(backendName, ui->view);
+    ui->view->layout()->addWidget(mBackend);
 
-    /* init position. */
-    mScrollPos = mWindowSize.width();
-    mScrollPosPeriod = 0;
-
-    /* init font */
-    mFont = QFont("Times", 48);
-    QFontMetrics fm(mFont);
-
-    /* create scene */
-    if (mGraphicsScene != nullptr) {
-        mGraphicsScene->clear();
+    /* a window on its own runs its own engine */
+    if (mOwnsEngine) {
+        mEngine = new TickerEngine();
     }
-    mGraphicsScene->setSceneRect(0, 0, mWindowSize.width(), mWindowSize.height());
-
-    /* create image */
-    StringImageCreater *strImageCreater = new StringImageCreater();
-    QString str = "Test Message";
-    int width = fm.width(str);
-    strImageCreater->setText(str);
-    strImageCreater->setImageHeight(mWindowSize.height());
-    strImageCreater->setImageWidth(width);
-    strImageCreater->setFont(mFont);
-    QImage dispImage = strImageCreater->generate();
-    mStrImg = new QGraphicsPixmapItem(QPixmap::fromImage(dispImage));
-    mStrImg->setPos(mScrollPos, 0);
-    mGraphicsScene->addItem(mStrImg);
-
-    /*
-     * Set the scene in View and Layout.
-     */
-    QGraphicsView *graphicsView = new QGraphicsView(this);
-    graphicsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    graphicsView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-	graphicsView->setAlignment(Qt::AlignLeft | Qt::AlignTop);
-    graphicsView->setScene(mGraphicsScene);
-    ui->view->layout()->addWidget(graphicsView);
 
     /* connection slots */
     connectSlots();
 
+    /* gauges are only read when the metrics are exported */
+    mBackend->frameMetrics()->setSampler([this](FrameMetrics &metrics) {
+        mEngine->sampleMetrics(metrics);
+        mBackend->sampleUploads(metrics);
+    });
+
 	/* adjust window size */
-	this->setFixedSize(mWindowSize.width(), mWindowSize.height());
+	fitToLanes();
 
 	/* move window start position */
 	this->move(0, 0);
-
-    delete strImageCreater;
 }
 
 QtTicker::~QtTicker()
 {
-    delete mStrImg;
-    delete mDx11Scene;
+    /* a pipelined engine may be presenting into the backend on its own thread */
+    mEngine->removeOutput(mBackend);
+    delete mBackend;
+    for (FrameOutput *output : mFrameOutputs) {
+        qDebug() << "[QtTicker::~QtTicker] - frame output:" << output->report();
+    }
+    qDeleteAll(mFrameOutputs);
+    if (mOwnsEngine) {
+        delete mEngine;
+    }
 }
 
 void QtTicker::connectSlots()
 {
-    connect(mDx11Scene, &QDirect3D11Widget::deviceInitialized, this, &QtTicker::init);
-    connect(mDx11Scene, &QDirect3D11Widget::ticked, this, &QtTicker::tick);
-    connect(mDx11Scene, &QDirect3D11Widget::rendered, this, &QtTicker::render);
+    connect(mBackend, &RenderBackend::deviceInitialized, this, &QtTicker::init);
 }
 
 void QtTicker::init(bool success)
@@ -95,25 +69,120 @@ void QtTicker::init(bool success)
     if (!success) {
         QMessageBox::critical(
             this
-            , "ERROR", "Direct3D widget initialization failed."
+            , "ERROR", "Render backend initialization failed."
             , QMessageBox::Ok);
         return;
     }
 
-    QTimer::singleShot(500, this, [&] { mDx11Scene->run(); });
-    disconnect(mDx11Scene, &QDirect3D11Widget::deviceInitialized, this, &QtTicker::init);
+    /* frames start once the device is up; the engine clock is shared */
+    mEngine->addOutput(mBackend, mViewport);
+    QTimer::singleShot(500, this, [&] { mEngine->start(); });
+    disconnect(mBackend, &RenderBackend::deviceInitialized, this, &QtTicker::init);
+}
+
+void QtTicker::setFrameRate(const double fps)
+{
+    mEngine->setFrameRate(fps);
+}
+
+TickerLane *QtTicker::addLane(const QString &name, const int height)
+{
+    TickerLane *lane = lanes()->addLane(name, height);
+    fitToLanes();
+    mEngine->wake();
+    return lane;
+}
+
+void QtTicker::clearLanes()
+{
+    lanes()->clear();
+    fitToLanes();
+    mEngine->wake();
+}
+
+void QtTicker::setViewport(const QRect &viewport)
+{
+    mViewport = viewport;
+    mEngine->setViewport(mBackend, mViewport);
+    fitToLanes();
+}
+
+void QtTicker::setScrollSpeed(const double pixelsPerSecond)
+{
+    for (int i = 0; i < lanes()->count(); ++i) {
+        lanes()->lane(i)->setSpeed(pixelsPerSecond);
+    }
+    mEngine->wake();
+}
+
+void QtTicker::setMessage(const QString &text)
+{
+    if (lanes()->count() > 0) {
+        lanes()->lane(0)->setMessage(text);
+    }
+    mEngine->wake();
+}
+
+void QtTicker::setStripSize(const QSize &size)
+{
+    lanes()->setSize(size);
+    fitToLanes();
+    mEngine->wake();
 }
 
-void QtTicker::tick()
+void QtTicker::fitToLanes()
 {
-    mScrollPos -= mMovingAmount;
+    const QSize size = mViewport.isNull() ? lanes()->size() : mViewport.size();
+    this->setFixedSize(size.width(), qMax(1, size.height()));
 }
 
-void QtTicker::render()
+bool QtTicker::serveMetrics(const QString &serverName)
 {
-    mStrImg->setPos(mScrollPos, 0);
-    /* check scroll position end.  */
-    if (mScrollPos < (-mScrollPosPeriod)) {
-        mScrollPos = mWindowSize.width();
+    /* parented to the backend so it goes away with the window; serves the whole engine frame */
+    MetricsServer *server = new MetricsServer(mEngine->frameMetrics(), mBackend);
+    if (!server->listen(serverName)) {
+        delete server;
+        return false;
     }
-}
\ No newline at end of file
+    qDebug() << "[QtTicker::serveMetrics] - serving metrics on" << server->fullServerName();
+    return true;
+}
+
+void QtTicker::setHudVisible(const bool visible)
+{
+    mBackend->setHudVisible(visible);
+}
+
+void QtTicker::setScrollBlit(const bool enabled)
+{
+    mBackend->setScrollBlit(enabled);
+}
+
+void QtTicker::setUploads(const bool enabled)
+{
+    mBackend->setUploadsEnabled(enabled);
+}
+
+bool QtTicker::addFrameOutput(const QString &spec)
+{
+    RasterRenderWidget *raster = qobject_cast<RasterRenderWidget *>(mBackend);
+    if (raster == nullptr) {
+        qWarning() << "[QtTicker::addFrameOutput] - frame outputs need the raster backend";
+        return false;
+    }
+    FrameOutput *output = FrameOutput::create(spec);
+    if (output == nullptr) {
+        return false;
+    }
+
+    /* a capture needs a frame in every slot, so the engine never idles */
+    mEngine->setProfile(TickerEngine::Throughput);
+
+    /* on the output's render thread, right after present; the cadence is the engine frame rate */
+    output->setFrameRate(mEngine->framePacer()->frameRate());
+    connect(mBackend, &RenderBackend::presented, this, [raster, output]() {
+        output->submit(raster, raster->frameTime());
+    }, Qt::DirectConnection);
+    mFrameOutputs.append(output);
+    return true;
+}
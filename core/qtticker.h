@@ -8,40 +8,74 @@
 
 #include <QtWidgets/QMainWindow>
 #include <QString>
-#include <QFont>
 #include <QSize>
-#include <QGraphicsPixmapItem>
-#include <QGraphicsScene>
+#include <QRect>
+#include <QList>
 
-#include "qdirect3d11widget.h"
+#include "renderbackend.h"
+#include "tickerengine.h"
+#include "frameoutput.h"
 #include "ui_qtticker.h"
 
+/*
+ * Ticker window: one output of a TickerEngine. Without an engine it creates
+ * its own; windows created on the same engine share its lanes, caches and
+ * clock, each showing its viewport of the scene.
+ */
 class QtTicker : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    explicit QtTicker(QWidget *parent = Q_NULLPTR);
+    explicit QtTicker(const QString &backendName = RenderBackend::defaultName(),
+                      TickerEngine *engine = Q_NULLPTR, QWidget *parent = Q_NULLPTR);
     ~QtTicker();
 
+    /* lanes stack top to bottom; the window follows their total height */
+    TickerLane *addLane(const QString &name, const int height);
+    void clearLanes();
+    LaneManager *lanes() { return mEngine->lanes(); }
+
+    /* part of the scene shown by this window; a null rect shows all of it */
+    void setViewport(const QRect &viewport);
+    QRect viewport() const { return mViewport; }
+
+    /* every lane */
+    void setScrollSpeed(const double pixelsPerSecond);
+    /* the first lane */
+    void setMessage(const QString &text);
+    /* total size, split evenly between the lanes */
+    void setStripSize(const QSize &size);
+
+    void setFrameRate(const double fps);
+
+    FeedIngest *feed() { return mEngine->feed(); }
+    RenderBackend *backend() { return mBackend; }
+    TickerEngine *engine() { return mEngine; }
+
+    bool serveMetrics(const QString &serverName);
+    void setHudVisible(const bool visible);
+    void setScrollBlit(const bool enabled);
+    /* keep composed images resident as backend textures, counting the bytes sent */
+    void setUploads(const bool enabled);
+
+    /* every presented frame also goes to a FrameOutput spec; raster backend only */
+    bool addFrameOutput(const QString &spec);
+
 private:
     Ui::QtTickerClass *ui;
 
-    QDirect3D11Widget *mDx11Scene;
-    QGraphicsScene *mGraphicsScene;
-    QGraphicsPixmapItem *mStrImg;
-    QSize mWindowSize;
-    QFont mFont;
-    double mScrollPosPeriod;
-    double mMovingAmount;
-    double mScrollPos;
+    RenderBackend *mBackend;
+    TickerEngine *mEngine;
+    bool mOwnsEngine;
+    QRect mViewport;
+    QList<FrameOutput *> mFrameOutputs;
 
     void connectSlots();
+    void fitToLanes();
 
 private slots:
     void init(bool success);
-    void tick();
-    void render();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "qualitygovernor.h"
+
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+const double DegradeLoad = 0.85;
+const double DegradeLate = 0.1;
+const double RecoverLoad = 0.5;
+const int RecoverWindows = 5;
+}
+
+QualityGovernor::QualityGovernor()
+    : mEnabled(true)
+    , mTargetRate(60.0)
+    , mLevel(Full)
+    , mTransitions(0)
+    , mFrames(0)
+    , mLate(0)
+    , mWork(0)
+    , mCalmWindows(0)
+{
+}
+
+void QualityGovernor::setEnabled(const bool enabled)
+{
+    mEnabled = enabled;
+    if (!mEnabled && mLevel != Full) {
+        transition(Full, "disabled", 0.0, 0.0);
+    }
+    restart();
+}
+
+void QualityGovernor::setTargetRate(const double fps)
+{
+    if (fps > 0.0) {
+        mTargetRate = fps;
+    }
+    restart();
+}
+
+void QualityGovernor::restart()
+{
+    mFrames = 0;
+    mLate = 0;
+    mWork = 0;
+}
+
+double QualityGovernor::rate(const Level level) const
+{
+    switch (level) {
+    case HalfRate: return mTargetRate / 2;
+    case QuarterRate: return mTargetRate / 4;
+    default: return mTargetRate;
+    }
+}
+
+bool QualityGovernor::addFrame(const qint64 nsecs)
+{
+    if (!mEnabled) {
+        return false;
+    }
+
+    const double budget = 1e9 / rate(mLevel);
+    ++mFrames;
+    mWork += nsecs;
+    if (nsecs > budget) {
+        ++mLate;
+    }
+
+    /* about a second of frames at the current rate */
+    if (mFrames < qMax(10, qCeil(rate(mLevel)))) {
+        return false;
+    }
+
+    const double mean = double(mWork) / mFrames;
+    const double late = double(mLate) / mFrames;
+    restart();
+
+    if ((mean > DegradeLoad * budget || late > DegradeLate) && mLevel + 1 < LevelCount) {
+        mCalmWindows = 0;
+        return transition(Level(mLevel + 1), "over budget", mean, late);
+    }
+
+    /* the level above must have room to spare, not just fit */
+    const bool calm = mLevel > Full && late == 0.0 && mean < RecoverLoad * 1e9 / rate(Level(mLevel - 1));
+    mCalmWindows = calm ? mCalmWindows + 1 : 0;
+    if (mCalmWindows >= RecoverWindows) {
+        mCalmWindows = 0;
+        return transition(Level(mLevel - 1), "recovered", mean, late);
+    }
+    return false;
+}
+
+bool QualityGovernor::transition(const Level level, const char *reason, const double mean, const double late)
+{
+    qWarning().nospace().noquote() << "[QualityGovernor::transition] - " << levelName(mLevel) << " -> " << levelName(level)
+                         << " (" << reason << "): mean frame " << mean / 1e6 << "ms, " << late * 100
+                         << "% late, budget " << 1e3 / rate(mLevel) << "ms at " << rate(mLevel) << "fps";
+    mLevel = level;
+    ++mTransitions;
+    return true;
+}
+
+QString QualityGovernor::levelName(const Level level)
+{
+    switch (level) {
+    case Full: return "full";
+    case WholePixels: return "whole-pixels";
+    case ShortLookahead: return "short-lookahead";
+    case HalfRate: return "half-rate";
+    case QuarterRate: return "quarter-rate";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <QString>
+
+/*
+ * Trades picture quality for frame time when frames run over budget.
+ *
+ * Frame work times are averaged over windows of about one second. A window
+ * whose mean uses more than DegradeLoad of the budget, or with more than
+ * DegradeLate of its frames over budget, steps one level down:
+ *   Full            everything as configured
+ *   WholePixels     no sub-pixel phases
+ *   ShortLookahead  fewer tiles and segments rasterized ahead
+ *   HalfRate        half the frame rate; scroll speed follows the scene clock
+ *   QuarterRate     a quarter of the frame rate
+ * A level is only given back after RecoverWindows windows in a row with no
+ * late frame and a mean that would stay under RecoverLoad of the budget of
+ * the level above, so the governor does not flap between two levels. Every
+ * transition is logged with the numbers that caused it.
+ */
+class QualityGovernor
+{
+public:
+    enum Level { Full, WholePixels, ShortLookahead, HalfRate, QuarterRate, LevelCount };
+
+    QualityGovernor();
+
+    void setEnabled(const bool enabled);
+    bool isEnabled() const { return mEnabled; }
+
+    /* the rate asked for at Full */
+    void setTargetRate(const double fps);
+
+    /* work time of one frame in ns; true when the level changed */
+    bool addFrame(const qint64 nsecs);
+    /* drops the current window, e.g. after idling or a reconfiguration */
+    void restart();
+
+    Level level() const { return mLevel; }
+    quint64 transitions() const { return mTransitions; }
+
+    /* the frame rate to run at on the current level */
+    double frameRate() const { return rate(mLevel); }
+    bool wholePixels() const { return mLevel >= WholePixels; }
+    bool shortLookahead() const { return mLevel >= ShortLookahead; }
+
+    static QString levelName(const Level level);
+
+private:
+    double rate(const Level level) const;
+    bool transition(const Level level, const char *reason, const double mean, const double late);
+
+    bool mEnabled;
+    double mTargetRate;
+    Level mLevel;
+    quint64 mTransitions;
+
+    int mFrames;
+    int mLate;
+    qint64 mWork;
+    int mCalmWindows;
+};
+
+#endif
@@ -0,0 +1,432 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "rasterdiskcache.h"
+#include "pixelbufferpool.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QVector>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char Magic[8] = { 'Q', 'T', 'T', 'K', 'R', 'A', 'S', 'T' };
+const quint32 ByteOrderMark = 0x01020304;
+const qint64 Alignment = 64;
+
+/* FNV-1a offset basis, mixed with the version so a format change misses every old key */
+const quint64 KeySeed = 14695981039346656037ULL ^ RasterDiskCache::Version;
+
+qint64 aligned(const qint64 offset)
+{
+    return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+bool pad(QSaveFile &file, const qint64 offset)
+{
+    static const char zeros[Alignment] = {};
+    const qint64 padding = aligned(offset) - offset;
+    return padding == 0 || file.write(zeros, padding) == padding;
+}
+
+/* bytes an entry adds to the file */
+qint64 entryBytes(const RasterDiskCache::IndexEntry &entry)
+{
+    return aligned(qint64(entry.bytesPerLine) * entry.height) + qint64(sizeof(RasterDiskCache::IndexEntry));
+}
+
+/* an entry of the next file and where its pixels are now: the old mapping or a pending image */
+struct SaveEntry
+{
+    RasterDiskCache::IndexEntry entry;
+    const uchar *pixels;
+};
+}
+
+class RasterDiskCache::SaveJob : public QRunnable
+{
+public:
+    explicit SaveJob(RasterDiskCache *cache)
+        : mCache(cache)
+    {
+    }
+
+    void run() override
+    {
+        mCache->save();
+        mCache->mSaving.fetchAndStoreOrdered(0);
+    }
+
+private:
+    RasterDiskCache *mCache;
+};
+
+RasterDiskCache::RasterDiskCache(const qint64 budgetBytes)
+    : mOpen(false)
+    , mMap(nullptr)
+    , mMapSize(0)
+    , mIndex(nullptr)
+    , mIndexCount(0)
+    , mGeneration(0)
+    , mPendingBytes(0)
+    , mBudget(budgetBytes)
+    , mSaving(0)
+    , mHits(0)
+    , mMisses(0)
+{
+    mSavePool.setMaxThreadCount(1);
+}
+
+RasterDiskCache::~RasterDiskCache()
+{
+    close();
+}
+
+RasterDiskCache *RasterDiskCache::global()
+{
+    static RasterDiskCache cache;
+    return &cache;
+}
+
+bool RasterDiskCache::open(const QString &path)
+{
+    close();
+
+    QWriteLocker locker(&mLock);
+    mPath = path;
+    mOpen = true;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    if (QFile::exists(path) && !mapFile()) {
+        qWarning() << "[RasterDiskCache::open] - ignoring unreadable cache" << path;
+    }
+    qDebug() << "[RasterDiskCache::open] -" << path << mIndexCount << "entries," << mMapSize << "bytes";
+    return true;
+}
+
+void RasterDiskCache::close()
+{
+    mSavePool.waitForDone();
+    save();
+
+    QWriteLocker locker(&mLock);
+    unmapFile();
+    mOpen = false;
+
+    QMutexLocker pendingLocker(&mPendingMutex);
+    mPending.clear();
+    mTouched.clear();
+    mPendingBytes = 0;
+}
+
+bool RasterDiskCache::isOpen() const
+{
+    QReadLocker locker(&mLock);
+    return mOpen;
+}
+
+bool RasterDiskCache::mapFile()
+{
+    mFile.setFileName(mPath);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = mFile.size();
+    uchar *map = size >= qint64(sizeof(FileHeader)) ? mFile.map(0, size) : nullptr;
+    if (map == nullptr) {
+        mFile.close();
+        return false;
+    }
+
+    const FileHeader *header = reinterpret_cast<const FileHeader *>(map);
+    const bool valid = std::memcmp(header->magic, Magic, sizeof(Magic)) == 0
+        && header->version == Version
+        && header->byteOrder == ByteOrderMark
+        && header->fileSize == quint64(size)
+        && header->indexOffset % Alignment == 0
+        && header->indexOffset + quint64(header->entryCount) * sizeof(IndexEntry) <= quint64(size);
+    if (!valid) {
+        mFile.unmap(map);
+        mFile.close();
+        return false;
+    }
+
+    mMap = map;
+    mMapSize = size;
+    mIndex = reinterpret_cast<const IndexEntry *>(map + header->indexOffset);
+    mIndexCount = int(header->entryCount);
+    mGeneration = header->generation;
+    return true;
+}
+
+void RasterDiskCache::unmapFile()
+{
+    if (mMap != nullptr) {
+        mFile.unmap(mMap);
+    }
+    mFile.close();
+    mMap = nullptr;
+    mMapSize = 0;
+    mIndex = nullptr;
+    mIndexCount = 0;
+    mGeneration = 0;
+}
+
+const RasterDiskCache::IndexEntry *RasterDiskCache::lookup(const quint64 key) const
+{
+    const IndexEntry *end = mIndex + mIndexCount;
+    const IndexEntry *entry = std::lower_bound(mIndex, end, key, [](const IndexEntry &a, const quint64 k) {
+        return a.key < k;
+    });
+    return (entry != end && entry->key == key) ? entry : nullptr;
+}
+
+QImage RasterDiskCache::find(const quint64 key)
+{
+    QReadLocker locker(&mLock);
+    if (!mOpen) {
+        return QImage();
+    }
+
+    const IndexEntry *entry = mIndex ? lookup(key) : nullptr;
+    const bool valid = entry != nullptr
+        && entry->format > QImage::Format_Invalid && entry->format < QImage::NImageFormats
+        && entry->offset + quint64(entry->bytesPerLine) * entry->height <= quint64(mMapSize);
+    if (valid) {
+        QImage image = PixelBufferPool::global()->acquire(QSize(int(entry->width), int(entry->height)),
+                                                          QImage::Format(entry->format));
+        const int rowBytes = qMin(image.bytesPerLine(), int(entry->bytesPerLine));
+        const uchar *src = mMap + entry->offset;
+        for (int y = 0; y < image.height(); ++y) {
+            std::memcpy(image.scanLine(y), src + qint64(y) * entry->bytesPerLine, size_t(rowBytes));
+        }
+        mHits.fetchAndAddRelaxed(1);
+
+        QMutexLocker pendingLocker(&mPendingMutex);
+        mTouched.insert(key);
+        return image;
+    }
+
+    QMutexLocker pendingLocker(&mPendingMutex);
+    const QImage pending = mPending.value(key);
+    if (!pending.isNull()) {
+        mHits.fetchAndAddRelaxed(1);
+    } else {
+        mMisses.fetchAndAddRelaxed(1);
+    }
+    return pending;
+}
+
+void RasterDiskCache::insert(const quint64 key, const QImage &image)
+{
+    if (image.isNull() || !isOpen()) {
+        return;
+    }
+
+    /* the file is trimmed to the budget by save(); this only bounds what waits in memory */
+    const qint64 bytes = aligned(qint64(image.bytesPerLine()) * image.height()) + qint64(sizeof(IndexEntry));
+    QMutexLocker locker(&mPendingMutex);
+    if (mPending.contains(key) || mPendingBytes + bytes > mBudget) {
+        return;
+    }
+    mPending.insert(key, image);
+    mPendingBytes += bytes;
+}
+
+bool RasterDiskCache::save()
+{
+    QMutexLocker saveLocker(&mSaveMutex);
+
+    QHash<quint64, QImage> pending;
+    QSet<quint64> touched;
+    qint64 budget = 0;
+    {
+        QMutexLocker locker(&mPendingMutex);
+        pending = mPending;
+        touched = mTouched;
+        budget = mBudget;
+    }
+    if (pending.isEmpty() && touched.isEmpty()) {
+        return true;
+    }
+
+    QSaveFile file(mPath);
+    QVector<IndexEntry> index;
+    int evicted = 0;
+    bool ok = false;
+    {
+        /* the old entries are read from the mapping, so it must stay put while writing */
+        QReadLocker locker(&mLock);
+        if (!mOpen) {
+            return false;
+        }
+        const quint32 generation = mGeneration + 1;
+
+        QVector<SaveEntry> entries;
+        for (int i = 0; i < mIndexCount; ++i) {
+            SaveEntry stored;
+            stored.entry = mIndex[i];
+            const qint64 bytes = qint64(stored.entry.bytesPerLine) * stored.entry.height;
+            if (stored.entry.offset + quint64(bytes) > quint64(mMapSize) || pending.contains(stored.entry.key)) {
+                continue;
+            }
+            if (touched.contains(stored.entry.key)) {
+                stored.entry.lastUsed = generation;
+            }
+            stored.pixels = mMap + stored.entry.offset;
+            entries.append(stored);
+        }
+        for (QHash<quint64, QImage>::const_iterator it = pending.constBegin(); it != pending.constEnd(); ++it) {
+            const QImage &image = it.value();
+            SaveEntry made;
+            std::memset(&made.entry, 0, sizeof(made.entry));
+            made.entry.key = it.key();
+            made.entry.width = quint32(image.width());
+            made.entry.height = quint32(image.height());
+            made.entry.bytesPerLine = quint32(image.bytesPerLine());
+            made.entry.format = quint32(image.format());
+            made.entry.lastUsed = generation;
+            made.pixels = image.constBits();
+            entries.append(made);
+        }
+
+        /* most recently used first; whatever no longer fits the budget is left behind */
+        std::stable_sort(entries.begin(), entries.end(), [](const SaveEntry &a, const SaveEntry &b) {
+            return a.entry.lastUsed > b.entry.lastUsed;
+        });
+        qint64 total = aligned(sizeof(FileHeader));
+        int kept = 0;
+        while (kept < entries.size() && total + entryBytes(entries.at(kept).entry) <= budget) {
+            total += entryBytes(entries.at(kept).entry);
+            ++kept;
+        }
+        evicted = entries.size() - kept;
+        entries.resize(kept);
+
+        ok = file.open(QIODevice::WriteOnly);
+
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        ok = ok && file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header));
+        ok = ok && pad(file, sizeof(header));
+
+        qint64 offset = aligned(sizeof(header));
+        for (int i = 0; ok && i < entries.size(); ++i) {
+            IndexEntry entry = entries.at(i).entry;
+            const qint64 bytes = qint64(entry.bytesPerLine) * entry.height;
+            ok = file.write(reinterpret_cast<const char *>(entries.at(i).pixels), bytes) == bytes && pad(file, offset + bytes);
+            entry.offset = quint64(offset);
+            index.append(entry);
+            offset = aligned(offset + bytes);
+        }
+
+        std::sort(index.begin(), index.end(), [](const IndexEntry &a, const IndexEntry &b) {
+            return a.key < b.key;
+        });
+        const qint64 indexBytes = qint64(index.size()) * qint64(sizeof(IndexEntry));
+        ok = ok && file.write(reinterpret_cast<const char *>(index.constData()), indexBytes) == indexBytes;
+
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.byteOrder = ByteOrderMark;
+        header.entryCount = quint32(index.size());
+        header.generation = generation;
+        header.indexOffset = quint64(offset);
+        header.fileSize = quint64(offset + indexBytes);
+        ok = ok && file.seek(0)
+            && file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header));
+    }
+    if (!ok) {
+        qWarning() << "[RasterDiskCache::save] - cannot write" << mPath << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    /* a mapped file cannot be replaced everywhere; find() copies, so nothing points into it */
+    QWriteLocker locker(&mLock);
+    unmapFile();
+    ok = file.commit();
+    if (!ok) {
+        qWarning() << "[RasterDiskCache::save] - cannot replace" << mPath << file.errorString();
+    }
+    mapFile();
+
+    if (ok) {
+        QMutexLocker pendingLocker(&mPendingMutex);
+        for (QHash<quint64, QImage>::const_iterator it = pending.constBegin(); it != pending.constEnd(); ++it) {
+            mPending.remove(it.key());
+        }
+        mTouched.subtract(touched);
+        mPendingBytes = 0;
+        for (const QImage &image : mPending) {
+            mPendingBytes += aligned(qint64(image.bytesPerLine()) * image.height()) + qint64(sizeof(IndexEntry));
+        }
+    }
+    qDebug() << "[RasterDiskCache::save] -" << mPath << mIndexCount << "entries," << mMapSize << "bytes,"
+             << evicted << "evicted";
+    return ok;
+}
+
+void RasterDiskCache::saveInBackground()
+{
+    if (!isOpen() || !mSaving.testAndSetOrdered(0, 1)) {
+        return;
+    }
+    mSavePool.start(new SaveJob(this));
+}
+
+void RasterDiskCache::setBudget(const qint64 bytes)
+{
+    QMutexLocker locker(&mPendingMutex);
+    mBudget = bytes;
+}
+
+int RasterDiskCache::entryCount() const
+{
+    QReadLocker locker(&mLock);
+    QMutexLocker pendingLocker(&mPendingMutex);
+    return mIndexCount + mPending.size();
+}
+
+qint64 RasterDiskCache::byteSize() const
+{
+    QReadLocker locker(&mLock);
+    QMutexLocker pendingLocker(&mPendingMutex);
+    return mMapSize + mPendingBytes;
+}
+
+quint64 RasterDiskCache::hash(const void *data, const int size, const quint64 seed)
+{
+    const uchar *bytes = static_cast<const uchar *>(data);
+    quint64 h = seed;
+    for (int i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+quint64 RasterDiskCache::key(const QString &text, const QFont &font, const QRgb color, const int height)
+{
+    const QString fontKey = font.key();
+    quint64 h = hash(text.constData(), text.size() * int(sizeof(QChar)), KeySeed);
+    h = hash("\n", 1, h);
+    h = hash(fontKey.constData(), fontKey.size() * int(sizeof(QChar)), h);
+    h = key(h, color);
+    return key(h, height);
+}
+
+quint64 RasterDiskCache::key(const quint64 key, const qint64 value)
+{
+    return hash(&value, sizeof(value), key);
+}
@@ -0,0 +1,138 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef RASTERDISKCACHE_H
+#define RASTERDISKCACHE_H
+
+#include <QAtomicInteger>
+#include <QFile>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QRgb>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+/*
+ * Strip tiles and board segments kept on disk between runs, so a restarted
+ * display composes what it showed before without shaping or rasterizing it.
+ *
+ * open() maps the file and touches nothing but its header: lookups binary
+ * search the sorted index inside the mapping and the OS pages pixels in on
+ * first use, so opening costs the same for ten entries or a million. Rasters
+ * made during the run are kept in memory and merged into a new file by save()
+ * (written aside, then renamed over the old one), which saveInBackground()
+ * runs on a thread of the cache's own. Found images are copied into pooled
+ * buffers, so nothing refers to the mapping once it is replaced.
+ *
+ * Every save counts a generation; an entry remembers the last one in which
+ * it was found or made. When the merged entries outgrow the budget, the
+ * least recently used are left out of the new file.
+ *
+ * Keys are stable 64-bit hashes (FNV-1a) of the text, QFont::key(), colour,
+ * height and tile, independent of the process hash seed.
+ *
+ * File layout, native byte order:
+ *   FileHeader at 0, pixel blobs from 64 on (each 64-byte aligned),
+ *   then entryCount IndexEntry records sorted by key at indexOffset.
+ */
+class RasterDiskCache
+{
+public:
+    enum { Version = 2 };
+
+    struct FileHeader
+    {
+        char magic[8];          // "QTTKRAST"
+        quint32 version;        // Version
+        quint32 byteOrder;      // 0x01020304 as written
+        quint32 entryCount;
+        quint32 generation;     // saves so far
+        quint64 indexOffset;
+        quint64 fileSize;
+    };
+
+    struct IndexEntry
+    {
+        quint64 key;
+        quint64 offset;         // first byte of the pixels
+        quint32 width;
+        quint32 height;
+        quint32 bytesPerLine;
+        quint32 format;         // QImage::Format
+        quint32 lastUsed;       // generation of the last save that found or made it
+        quint32 reserved;
+    };
+
+    explicit RasterDiskCache(const qint64 budgetBytes = qint64(512) << 20);
+    ~RasterDiskCache();
+
+    /* shared by every strip and board; closed (a no-op) until open() */
+    static RasterDiskCache *global();
+
+    /* a missing or unreadable file starts an empty cache that save() creates */
+    bool open(const QString &path);
+    /* waits for a background save, saves, then unmaps */
+    void close();
+    bool save();
+    /* save() on the cache's thread; does nothing while one is still running */
+    void saveInBackground();
+    bool isOpen() const;
+
+    /* a copy of the stored raster, or a null image; any thread */
+    QImage find(const quint64 key);
+    /* kept for the next save() unless the unsaved rasters fill the budget; any thread */
+    void insert(const quint64 key, const QImage &image);
+
+    /* largest size of the file; older entries are evicted to stay below it */
+    void setBudget(const qint64 bytes);
+
+    static quint64 key(const QString &text, const QFont &font, const QRgb color, const int height);
+    static quint64 key(const quint64 key, const qint64 value);
+
+    quint64 hits() const { return mHits.load(); }
+    quint64 misses() const { return mMisses.load(); }
+    int entryCount() const;
+    qint64 byteSize() const;
+
+private:
+    class SaveJob;
+
+    static quint64 hash(const void *data, const int size, const quint64 seed);
+
+    bool mapFile();
+    void unmapFile();
+    const IndexEntry *lookup(const quint64 key) const;
+
+    /* the mapping: read-locked by find() and save(), write-locked to replace it */
+    mutable QReadWriteLock mLock;
+    QMutex mSaveMutex;
+    QString mPath;
+    bool mOpen;
+    QFile mFile;
+    uchar *mMap;
+    qint64 mMapSize;
+    const IndexEntry *mIndex;
+    int mIndexCount;
+    quint32 mGeneration;
+
+    /* rasters made this run and stored keys found since, not yet saved */
+    mutable QMutex mPendingMutex;
+    QHash<quint64, QImage> mPending;
+    QSet<quint64> mTouched;
+    qint64 mPendingBytes;
+    qint64 mBudget;
+
+    QThreadPool mSavePool;
+    QAtomicInt mSaving;
+
+    QAtomicInteger<quint64> mHits;
+    QAtomicInteger<quint64> mMisses;
+};
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "rasterrenderwidget.h"
+#include "composite.h"
+
+#include <QMultiHash>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QRegion>
+#include <QThread>
+#include <QtMath>
+
+#include <algorithm>
+
+#include <string.h>
+
+RasterRenderWidget::RasterRenderWidget(QWidget *parent)
+    : RenderBackend(parent)
+    , mSceneOpen(false)
+    , mBackColor(QColor::fromRgbF(0.0, 0.135, 0.481, 1.0))
+    , mRedrawnArea(0)
+    , mFullRedraw(true)
+{
+    /* the framebuffer covers the whole widget, so skip Qt's background fill */
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+}
+
+RasterRenderWidget::~RasterRenderWidget()
+{
+}
+
+bool RasterRenderWidget::init()
+{
+    resizeBuffers(size());
+    if (!m_bRenderActive) emit ticked();
+    return true;
+}
+
+QImage RasterRenderWidget::frameBuffer() const
+{
+    if (isUnrolled()) {
+        return mFrameBuffer;
+    }
+
+    QImage frame(mFrameBuffer.size(), mFrameBuffer.format());
+    QPainter painter(&frame);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    drawUnrolled(painter);
+    return frame;
+}
+
+void RasterRenderWidget::readFrame(uchar *bits, const int bytesPerLine) const
+{
+    const int width = mFrameBuffer.width();
+    for (int y = 0; y < mFrameBuffer.height(); ++y) {
+        int offset = 0;
+        for (const Band &band : mBands) {
+            if (y >= band.top && y < band.top + band.height) {
+                offset = band.offset;
+                break;
+            }
+        }
+
+        /* ring columns [offset, width) then [0, offset) */
+        const uchar *line = mFrameBuffer.constScanLine(y);
+        uchar *target = bits + qint64(y) * bytesPerLine;
+        memcpy(target, line + offset * 4, size_t(width - offset) * 4);
+        memcpy(target + (width - offset) * 4, line, size_t(offset) * 4);
+    }
+}
+
+void RasterRenderWidget::beginScene()
+{
+    if (mFrameBuffer.isNull()) {
+        return;
+    }
+
+    if (m_bScrollBlit) {
+        mComposed.clear();
+        mPlaced.clear();
+        return;
+    }
+
+    /* a full repaint starts the rings over */
+    mBands.clear();
+    mFullRedraw = true;
+    mRedrawnArea = qint64(mFrameBuffer.width()) * mFrameBuffer.height();
+
+    mSceneOpen = true;
+    fillRect(mFrameBuffer.rect());
+}
+
+void RasterRenderWidget::compose(const QImage &image, const QPointF &pos)
+{
+    uploadImage(image);
+    if (m_bScrollBlit) {
+        /* whole pixels only, so a shifted frame matches a redrawn one */
+        Placed placed;
+        placed.key = image.cacheKey();
+        placed.rect = QRect(QPoint(qFloor(pos.x() + 0.5), qFloor(pos.y() + 0.5)), image.size());
+        mComposed.append(image);
+        mPlaced.append(placed);
+        return;
+    }
+
+    if (!mSceneOpen) {
+        return;
+    }
+
+    blendImage(image, QPoint(qFloor(pos.x() + 0.5), qFloor(pos.y() + 0.5)), mFrameBuffer.rect());
+}
+
+UploadManager *RasterRenderWidget::createUploadManager()
+{
+    return new SoftwareUploadManager(UploadManager::RGBA8);
+}
+
+void RasterRenderWidget::present()
+{
+    if (m_bScrollBlit) {
+        presentScrolled();
+        return;
+    }
+
+    if (!mSceneOpen) {
+        return;
+    }
+
+    mSceneOpen = false;
+    requestUpdate();
+}
+
+void RasterRenderWidget::resizeBuffers(const QSize &size)
+{
+    mSceneOpen = false;
+    mBands.clear();
+    mFullRedraw = true;
+    mPrevious.clear();
+
+    if (size.isEmpty()) {
+        mFrameBuffer = QImage();
+        return;
+    }
+    mFrameBuffer = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    mFrameBuffer.fill(mBackColor);
+}
+
+void RasterRenderWidget::paintEvent(QPaintEvent *event)
+{
+    QMutexLocker locker(&m_frameMutex);
+    if (mFrameBuffer.isNull()) {
+        return;
+    }
+
+    QPainter painter(this);
+    if (isUnrolled()) {
+        painter.drawImage(event->rect(), mFrameBuffer, event->rect());
+        return;
+    }
+    drawUnrolled(painter);
+}
+
+void RasterRenderWidget::presentScrolled()
+{
+    if (mFrameBuffer.isNull()) {
+        return;
+    }
+
+    const int width = mFrameBuffer.width();
+    const QRect screen = mFrameBuffer.rect();
+    const QVector<ScrollBand> layout = bandLayout();
+
+    bool sameLayout = !mFullRedraw && layout.size() == mBands.size();
+    for (int i = 0; sameLayout && i < layout.size(); ++i) {
+        sameLayout = layout.at(i).top == mBands.at(i).top && layout.at(i).height == mBands.at(i).height;
+    }
+
+    QRegion dirty;
+    if (!sameLayout) {
+        mBands.clear();
+        for (const ScrollBand &scroll : layout) {
+            Band band;
+            band.top = scroll.top;
+            band.height = scroll.height;
+            band.offset = 0;
+            mBands.append(band);
+        }
+        dirty = screen;
+        mFullRedraw = false;
+    } else {
+        /* the previous frame moves with each ring; the columns it uncovers are new */
+        for (int i = 0; i < mBands.size(); ++i) {
+            Band &band = mBands[i];
+            const int dx = layout.at(i).dx;
+            if (qAbs(dx) >= width) {
+                band.offset = 0;
+                dirty += QRect(0, band.top, width, band.height);
+            } else {
+                band.offset = ((band.offset - dx) % width + width) % width;
+                if (dx < 0) {
+                    dirty += QRect(width + dx, band.top, -dx, band.height);
+                } else if (dx > 0) {
+                    dirty += QRect(0, band.top, dx, band.height);
+                }
+            }
+        }
+
+        /* where the pixels of a previous item are now, band by band */
+        auto shifted = [&](const QRect &rect, bool *uniform, int *shift) {
+            QRegion region;
+            *uniform = true;
+            bool first = true;
+            for (int i = 0; i < mBands.size(); ++i) {
+                const QRect rows = rect & QRect(0, mBands.at(i).top, width, mBands.at(i).height);
+                if (rows.isEmpty()) {
+                    continue;
+                }
+                const int dx = layout.at(i).dx;
+                region += rows.translated(dx, 0);
+                *uniform = *uniform && (first || dx == *shift);
+                *shift = dx;
+                first = false;
+            }
+            return region;
+        };
+
+        /* items that moved exactly with their band are already in place */
+        QMultiHash<qint64, QRect> previous;
+        for (const Placed &placed : mPrevious) {
+            bool uniform = false;
+            int shift = 0;
+            const QRegion region = shifted(placed.rect, &uniform, &shift);
+            if (uniform) {
+                previous.insert(placed.key, placed.rect.translated(shift, 0));
+            } else {
+                dirty += region;
+            }
+        }
+        for (const Placed &placed : mPlaced) {
+            const QMultiHash<qint64, QRect>::iterator it = previous.find(placed.key, placed.rect);
+            if (it != previous.end()) {
+                previous.erase(it);
+            } else {
+                dirty += placed.rect;
+            }
+        }
+        for (QMultiHash<qint64, QRect>::const_iterator it = previous.constBegin(); it != previous.constEnd(); ++it) {
+            dirty += it.value();
+        }
+        dirty &= screen;
+    }
+
+    mRedrawnArea = 0;
+    for (const QRect &rect : dirty) {
+        mRedrawnArea += qint64(rect.width()) * rect.height();
+    }
+
+    if (!dirty.isEmpty()) {
+        /* screen x of a band lives at ring column (offset + x) mod width: two spans */
+        for (const Band &band : mBands) {
+            const QRect rows(0, band.top, width, band.height);
+            const QRegion bandDirty = dirty & rows;
+            if (bandDirty.isEmpty()) {
+                continue;
+            }
+            for (const int shift : { band.offset, band.offset - width }) {
+                const QRegion region = bandDirty.translated(shift, 0) & rows;
+                for (const QRect &rect : region) {
+                    fillRect(rect);
+                    for (int i = 0; i < mPlaced.size(); ++i) {
+                        const QRect target = mPlaced.at(i).rect.translated(shift, 0);
+                        if (rect.intersects(target)) {
+                            blendImage(mComposed.at(i), target.topLeft(), rect);
+                        }
+                    }
+                }
+            }
+        }
+        requestUpdate();
+    }
+
+    mPrevious.swap(mPlaced);
+    mComposed.clear();
+}
+
+void RasterRenderWidget::requestUpdate()
+{
+    /* QWidget::update() is GUI thread only */
+    if (QThread::currentThread() == thread()) {
+        update();
+    } else {
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+    }
+}
+
+QVector<RenderBackend::ScrollBand> RasterRenderWidget::bandLayout() const
+{
+    /* the reported bands in row order, with the rows between them as still bands */
+    QVector<ScrollBand> reported = m_scrollBands;
+    std::sort(reported.begin(), reported.end(), [](const ScrollBand &a, const ScrollBand &b) {
+        return a.top < b.top;
+    });
+
+    const int height = mFrameBuffer.height();
+    QVector<ScrollBand> layout;
+    int row = 0;
+    for (const ScrollBand &band : reported) {
+        const int top = qMax(band.top, row);
+        const int bottom = qMin(band.top + band.height, height);
+        if (bottom <= top) {
+            continue;
+        }
+        if (top > row) {
+            layout.append(ScrollBand{ row, top - row, 0 });
+        }
+        layout.append(ScrollBand{ top, bottom - top, band.dx });
+        row = bottom;
+    }
+    if (row < height) {
+        layout.append(ScrollBand{ row, height - row, 0 });
+    }
+    return layout;
+}
+
+bool RasterRenderWidget::isUnrolled() const
+{
+    for (const Band &band : mBands) {
+        if (band.offset != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RasterRenderWidget::drawUnrolled(QPainter &painter) const
+{
+    /* every band: [offset, width) then [0, offset) */
+    const int width = mFrameBuffer.width();
+    for (const Band &band : mBands) {
+        painter.drawImage(QPoint(0, band.top), mFrameBuffer,
+                          QRect(band.offset, band.top, width - band.offset, band.height));
+        if (band.offset > 0) {
+            painter.drawImage(QPoint(width - band.offset, band.top), mFrameBuffer,
+                              QRect(0, band.top, band.offset, band.height));
+        }
+    }
+}
+
+void RasterRenderWidget::fillRect(const QRect &rect)
+{
+    const QRect target = rect & mFrameBuffer.rect();
+    if (target.isEmpty()) {
+        return;
+    }
+
+    const CompositeKernels &kernels = Composite::kernels();
+    const quint32 color = qPremultiply(mBackColor.rgba());
+    for (int y = target.top(); y <= target.bottom(); ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(mFrameBuffer.scanLine(y)) + target.x();
+        kernels.fill(line, color, target.width());
+    }
+}
+
+void RasterRenderWidget::blendImage(const QImage &image, const QPoint &pos, const QRect &clip)
+{
+    const QRect target = QRect(pos, image.size()) & clip & mFrameBuffer.rect();
+    if (target.isEmpty()) {
+        return;
+    }
+
+    /* strips and tiles are already premultiplied; anything else is converted once */
+    const QImage source = (image.format() == QImage::Format_ARGB32_Premultiplied)
+        ? image
+        : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const CompositeKernels &kernels = Composite::kernels();
+    const int sx = target.x() - pos.x();
+    const int sy = target.y() - pos.y();
+    for (int y = 0; y < target.height(); ++y) {
+        const quint32 *src = reinterpret_cast<const quint32 *>(source.constScanLine(sy + y)) + sx;
+        quint32 *dst = reinterpret_cast<quint32 *>(mFrameBuffer.scanLine(target.y() + y)) + target.x();
+        kernels.sourceOver(dst, src, target.width());
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef RASTERRENDERWIDGET_H
+#define RASTERRENDERWIDGET_H
+
+#include <QColor>
+#include <QImage>
+#include <QRect>
+#include <QVector>
+
+#include "renderbackend.h"
+
+class QPainter;
+
+/*
+ * Software backend. Frames are composed into a QImage framebuffer with the
+ * SIMD span kernels from Composite, so it runs on any platform plugin
+ * including "offscreen".
+ *
+ * In scroll-blit mode every scroll band (lane) of the framebuffer is a ring:
+ * scrolling only moves the band's ring offset, and present() repaints just
+ * the columns that scrolled in plus the items that are new, gone or moved
+ * differently from their band, as told apart by QImage::cacheKey(). The cost
+ * of a frame then follows the scroll speed and the rate of change, not the
+ * window area.
+ */
+class RasterRenderWidget : public RenderBackend
+{
+    Q_OBJECT
+
+public:
+    explicit RasterRenderWidget(QWidget *parent = Q_NULLPTR);
+    ~RasterRenderWidget();
+
+    bool init() override;
+    void beginScene() override;
+    void compose(const QImage &image, const QPointF &pos) override;
+    void present() override;
+    void resizeBuffers(const QSize &size) override;
+
+    /* the framebuffer is painted from the GUI thread under the frame mutex */
+    bool rendersOffThread() const override { return true; }
+
+    QSize frameSize() const { return mFrameBuffer.size(); }
+
+    /* the current frame, unrolled from the rings if needed */
+    QImage frameBuffer() const;
+
+    /* the same, unrolled straight into caller memory of the framebuffer size */
+    void readFrame(uchar *bits, const int bytesPerLine) const;
+
+    /* pixels repainted by the last frame */
+    qint64 redrawnArea() const { return mRedrawnArea; }
+
+    QColor backColor() const { return mBackColor; }
+    void setBackColor(const QColor color) {
+        mBackColor = color;
+    }
+
+protected:
+    /* host-memory textures in the d3d11 byte order, to measure upload bandwidth anywhere */
+    UploadManager *createUploadManager() override;
+
+private:
+    struct Placed
+    {
+        qint64 key;
+        QRect rect;
+    };
+
+    struct Band
+    {
+        int top;
+        int height;
+        int offset;     // ring column shown at x = 0
+    };
+
+    void paintEvent(QPaintEvent *event) override;
+    void presentScrolled();
+    void requestUpdate();
+    QVector<ScrollBand> bandLayout() const;
+    bool isUnrolled() const;
+    void drawUnrolled(QPainter &painter) const;
+
+    /* in framebuffer coordinates, clipped to clip */
+    void fillRect(const QRect &rect);
+    void blendImage(const QImage &image, const QPoint &pos, const QRect &clip);
+
+    QImage mFrameBuffer;
+    bool mSceneOpen;
+    QColor mBackColor;
+    qint64 mRedrawnArea;
+
+    /* scroll-blit state */
+    QVector<QImage> mComposed;
+    QVector<Placed> mPlaced;
+    QVector<Placed> mPrevious;
+    QVector<Band> mBands;
+    bool mFullRedraw;
+};
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "renderbackend.h"
+#include "rasterrenderwidget.h"
+#ifdef Q_OS_WIN
+#include "qdirect3d11widget.h"
+#endif
+
+#include <QDebug>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QShowEvent>
+#include <QResizeEvent>
+
+RenderBackend::RenderBackend(QWidget *parent)
+    : QWidget(parent)
+    , m_frameTime(0.0)
+    , m_bScrollBlit(false)
+    , m_bVSync(false)
+    , m_bHudVisible(false)
+    , m_hudUpdatedAt(0)
+    , m_bUploads(false)
+    , m_pUploads(Q_NULLPTR)
+    , m_bUploadStats(false)
+    , m_uploadFormat(UploadManager::RGBA8)
+    , m_bDeviceInitialized(false)
+    , m_bRenderActive(false)
+    , m_bStarted(false)
+{
+    m_pacer.setFrameRate(60.0);
+    connect(&m_pacer, &FramePacer::frame, this, &RenderBackend::onFrame);
+    m_stageClock.start();
+}
+
+RenderBackend::~RenderBackend()
+{
+    releaseUploads();
+}
+
+RenderBackend *RenderBackend::create(const QString &name, QWidget *parent)
+{
+#ifdef Q_OS_WIN
+    if (name == "d3d11") {
+        return new QDirect3D11Widget(parent);
+    }
+#endif
+    if (name == "raster") {
+        return new RasterRenderWidget(parent);
+    }
+
+    qWarning() << "[RenderBackend::create] - Unknown backend" << name
+               << ", falling back to" << defaultName();
+    return create(defaultName(), parent);
+}
+
+QStringList RenderBackend::availableNames()
+{
+    QStringList names;
+#ifdef Q_OS_WIN
+    names << "d3d11";
+#endif
+    names << "raster";
+    return names;
+}
+
+QString RenderBackend::defaultName()
+{
+    return availableNames().first();
+}
+
+void RenderBackend::run()
+{
+    m_pacer.start();
+    m_bRenderActive = m_bStarted = true;
+}
+
+void RenderBackend::pauseFrames()
+{
+    if (!m_pacer.isActive() || !m_bStarted) return;
+
+    m_pacer.stop();
+    m_bRenderActive = false;
+}
+
+void RenderBackend::continueFrames()
+{
+    if (m_pacer.isActive() || !m_bStarted) return;
+
+    m_pacer.start();
+    m_bRenderActive = true;
+}
+
+void RenderBackend::resetFrameRate(const double fps)
+{
+    /* only the frame cadence changes; scroll speed follows frameTime() */
+    m_pacer.setFrameRate(fps);
+}
+
+void RenderBackend::setUploadsEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_frameMutex);
+    m_bUploads = enabled;
+    if (!enabled) {
+        delete m_pUploads;
+        m_pUploads = Q_NULLPTR;
+
+        QMutexLocker statsLocker(&m_uploadStatsMutex);
+        m_bUploadStats = false;
+    }
+}
+
+void RenderBackend::releaseUploads()
+{
+    QMutexLocker locker(&m_frameMutex);
+    delete m_pUploads;
+    m_pUploads = Q_NULLPTR;
+}
+
+bool RenderBackend::uploadStats(UploadManager::Stats *stats, UploadManager::Format *format) const
+{
+    /* not m_frameMutex: the HUD samples the metrics while a frame holds it */
+    QMutexLocker locker(&m_uploadStatsMutex);
+    if (!m_bUploadStats) {
+        return false;
+    }
+    *stats = m_uploadStats;
+    if (format != Q_NULLPTR) *format = m_uploadFormat;
+    return true;
+}
+
+void RenderBackend::sampleUploads(FrameMetrics &metrics) const
+{
+    UploadManager::Stats stats;
+    if (!uploadStats(&stats)) {
+        return;
+    }
+    metrics.setGauge("upload_frame_bytes", "Bytes uploaded to textures by the last frame.", double(stats.lastFrameBytes));
+    metrics.setGauge("upload_peak_frame_bytes", "Most bytes uploaded to textures by one frame.", double(stats.peakFrameBytes));
+    metrics.setGauge("upload_bytes", "Bytes uploaded to textures, cumulative.", double(stats.bytes));
+    metrics.setGauge("upload_rows_skipped", "Rows of rewritten images that were unchanged and not sent.",
+                     double(stats.rowsSkipped));
+    metrics.setGauge("upload_textures", "Textures resident for composed images.", stats.textures);
+    metrics.setGauge("upload_texture_bytes", "Bytes of textures resident for composed images.", double(stats.textureBytes));
+}
+
+void RenderBackend::scrollBand(const int top, const int height, const int dx)
+{
+    for (ScrollBand &band : m_scrollBands) {
+        if (band.top == top && band.height == height) {
+            band.dx += dx;
+            return;
+        }
+    }
+
+    ScrollBand band;
+    band.top = top;
+    band.height = height;
+    band.dx = dx;
+    m_scrollBands.append(band);
+}
+
+void RenderBackend::showEvent(QShowEvent *event)
+{
+    if (!m_bDeviceInitialized) {
+        m_bDeviceInitialized = init();
+        emit deviceInitialized(m_bDeviceInitialized);
+    }
+
+    QWidget::showEvent(event);
+}
+
+void RenderBackend::resizeEvent(QResizeEvent *event)
+{
+    if (m_bDeviceInitialized) {
+        {
+            QMutexLocker locker(&m_frameMutex);
+            resizeBuffers(event->size());
+        }
+        emit widgetResized();
+    }
+
+    QWidget::resizeEvent(event);
+}
+
+void RenderBackend::onFrame()
+{
+    renderFrame(m_pacer.sceneTime() / 1e9);
+}
+
+void RenderBackend::renderFrame(const double sceneTime)
+{
+    const qint64 start = m_stageClock.nsecsElapsed();
+    m_frameTime = sceneTime;
+    if (m_bRenderActive) emit ticked();
+
+    const qint64 ticked = m_stageClock.nsecsElapsed();
+    QMutexLocker locker(&m_frameMutex);
+    if (m_bUploads && m_pUploads == Q_NULLPTR && m_bDeviceInitialized) {
+        m_pUploads = createUploadManager();
+    }
+    if (m_pUploads != Q_NULLPTR) m_pUploads->beginFrame();
+    beginScene();
+    emit rendered();
+    if (m_bHudVisible) composeHud();
+
+    const qint64 composed = m_stageClock.nsecsElapsed();
+    present();
+    if (m_pUploads != Q_NULLPTR) {
+        m_pUploads->endFrame();
+
+        QMutexLocker statsLocker(&m_uploadStatsMutex);
+        m_uploadStats = m_pUploads->stats();
+        m_uploadFormat = m_pUploads->format();
+        m_bUploadStats = true;
+    }
+    emit presented();
+
+    m_scrollBands.clear();
+    locker.unlock();
+
+    const qint64 presented = m_stageClock.nsecsElapsed();
+    m_metrics.addFrame(ticked - start, composed - ticked, presented - composed, m_pacer.period());
+}
+
+void RenderBackend::composeHud()
+{
+    /* the text is only redrawn a few times per second */
+    const qint64 now = m_stageClock.elapsed();
+    if (m_hudImage.isNull() || now - m_hudUpdatedAt >= 250) {
+        m_hudUpdatedAt = now;
+
+        QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+        font.setPixelSize(11);
+        const QString text = m_metrics.hudText();
+        const QRect bounds = QFontMetrics(font).boundingRect(QRect(0, 0, width(), height()), Qt::AlignLeft | Qt::AlignTop, text);
+
+        m_hudImage = QImage(bounds.size() + QSize(8, 4), QImage::Format_ARGB32_Premultiplied);
+        m_hudImage.fill(QColor(0, 0, 0, 160));
+        QPainter painter(&m_hudImage);
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+        painter.drawText(m_hudImage.rect().adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop, text);
+    }
+    compose(m_hudImage, QPointF(0, 0));
+}
@@ -0,0 +1,169 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
+#include <QPointF>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "framepacer.h"
+#include "framemetrics.h"
+#include "scenetarget.h"
+#include "uploadmanager.h"
+
+/*
+ * A backend owns the frame pacer and, for every frame, runs
+ *   ticked() -> beginScene() -> rendered() -> present().
+ * A TickerEngine output does not use its own pacer: the engine calls
+ * renderFrame() with the shared scene time and replays the frame's display
+ * list into compose() from rendered().
+ *
+ * In scroll-blit mode the ticker also reports how far each horizontal band of
+ * the scene (one per lane) moved with scrollBand(); backends that keep their
+ * previous frame shift it and only redraw the exposed columns and the items
+ * that changed.
+ *
+ * The time spent in each of those stages is recorded into frameMetrics();
+ * with the HUD on, a summary is composed on top of every frame.
+ *
+ * With uploads on, every composed image is also kept resident as a texture
+ * in the backend's pixel format through its UploadManager, which counts the
+ * bytes each frame sends.
+ *
+ * A frame rendered off the GUI thread holds the frame mutex from
+ * beginScene() to presented(); resizing takes it too, and so must painting
+ * code that reads what the frame wrote.
+ */
+class RenderBackend : public QWidget, public SceneTarget
+{
+    Q_OBJECT
+
+public:
+    struct ScrollBand
+    {
+        int top;
+        int height;
+        int dx;     // whole pixels since the last frame
+    };
+
+    explicit RenderBackend(QWidget *parent = Q_NULLPTR);
+    virtual ~RenderBackend();
+
+    static RenderBackend *create(const QString &name, QWidget *parent = Q_NULLPTR);
+    static QStringList availableNames();
+    static QString defaultName();
+
+    void run();
+    void pauseFrames();
+    void continueFrames();
+
+    /* one complete frame at the given scene time, outside the pacer */
+    void renderFrame(const double sceneTime);
+
+    void resetFrameRate(const double fps);
+    double frameRate() const { return m_pacer.frameRate(); }
+
+    /* scene time of the current frame in seconds; stands still while paused */
+    double frameTime() const { return m_frameTime; }
+    FramePacer *framePacer() { return &m_pacer; }
+    FrameMetrics *frameMetrics() { return &m_metrics; }
+
+    void setScrollBlit(bool enabled) { m_bScrollBlit = enabled; }
+    bool scrollBlit() const { return m_bScrollBlit; }
+
+    void scrollBand(const int top, const int height, const int dx) override;
+
+    void setHudVisible(bool visible) { m_bHudVisible = visible; }
+    bool hudVisible() const { return m_bHudVisible; }
+
+    /* the manager is created by the next frame, once the device exists */
+    void setUploadsEnabled(bool enabled);
+    bool uploadsEnabled() const { return m_bUploads; }
+    /* as of the last frame, false before one ran with uploads; any thread, also while rendering */
+    bool uploadStats(UploadManager::Stats *stats, UploadManager::Format *format = Q_NULLPTR) const;
+    void sampleUploads(FrameMetrics &metrics) const;
+
+    bool renderActive() const { return m_bRenderActive; }
+    void setRenderActive(bool active) { m_bRenderActive = active; }
+
+    virtual bool init() = 0;
+    virtual void beginScene() = 0;
+    virtual void present() = 0;
+    virtual void resizeBuffers(const QSize &size) = 0;
+
+    /* whether renderFrame() may run on a worker thread */
+    virtual bool rendersOffThread() const { return false; }
+
+    /* whether present() can wait for the display interval when vsync is on */
+    virtual bool supportsVSync() const { return false; }
+    void setVSync(bool enabled) { m_bVSync = enabled; }
+    bool vsync() const { return m_bVSync; }
+
+signals:
+    void deviceInitialized(bool success);
+    void widgetResized();
+
+    void ticked();
+    void rendered();
+    /* after present(), on the thread that rendered the frame */
+    void presented();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+protected slots:
+    void onFrame();
+
+protected:
+    void composeHud();
+
+    /* null where the backend has no textures to upload to */
+    virtual UploadManager *createUploadManager() { return Q_NULLPTR; }
+    /* from compose(); a no-op while uploads are off */
+    void uploadImage(const QImage &image) {
+        if (m_pUploads != Q_NULLPTR) m_pUploads->upload(image);
+    }
+    /* before the device the textures live on goes away */
+    void releaseUploads();
+
+    FramePacer m_pacer;
+    double m_frameTime;
+
+    bool m_bScrollBlit;
+    bool m_bVSync;
+    QVector<ScrollBand> m_scrollBands;
+
+    FrameMetrics m_metrics;
+    QElapsedTimer m_stageClock;
+    bool m_bHudVisible;
+    QImage m_hudImage;
+    qint64 m_hudUpdatedAt;
+
+    QMutex m_frameMutex;
+
+    bool m_bUploads;
+    UploadManager *m_pUploads;
+
+    /* published by renderFrame(); the manager itself belongs to the rendering thread */
+    mutable QMutex m_uploadStatsMutex;
+    bool m_bUploadStats;
+    UploadManager::Stats m_uploadStats;
+    UploadManager::Format m_uploadFormat;
+
+    bool m_bDeviceInitialized;
+    bool m_bRenderActive;
+    bool m_bStarted;
+};
+
+#endif
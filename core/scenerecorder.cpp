@@ -0,0 +1,87 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "scenerecorder.h"
+
+#include <QVarLengthArray>
+
+SceneRecorder::SceneRecorder()
+{
+}
+
+void SceneRecorder::clear()
+{
+    clearItems();
+    mBands.clear();
+}
+
+void SceneRecorder::clearItems()
+{
+    /* QVector keeps its capacity, the list is about the same size every frame */
+    mImages.clear();
+    mLeft.clear();
+    mTop.clear();
+    mRight.clear();
+    mBottom.clear();
+    mPos.clear();
+}
+
+void SceneRecorder::compose(const QImage &image, const QPointF &pos)
+{
+    if (image.isNull()) {
+        return;
+    }
+    mImages.append(image);
+    mPos.append(pos);
+    mLeft.append(float(pos.x()));
+    mTop.append(float(pos.y()));
+    mRight.append(float(pos.x() + image.width()));
+    mBottom.append(float(pos.y() + image.height()));
+}
+
+void SceneRecorder::scrollBand(const int top, const int height, const int dx)
+{
+    Band band;
+    band.top = top;
+    band.height = height;
+    band.dx = dx;
+    mBands.append(band);
+}
+
+void SceneRecorder::replay(SceneTarget *target, const QRect &viewport) const
+{
+    /* bands keep their shift, clipped to the rows the viewport shows */
+    for (const Band &band : mBands) {
+        const int top = qMax(band.top, viewport.top());
+        const int bottom = qMin(band.top + band.height, viewport.top() + viewport.height());
+        if (bottom > top) {
+            target->scrollBand(top - viewport.top(), bottom - top, band.dx);
+        }
+    }
+
+    /* the overlap test has no branches and vectorizes; only visible items are composed */
+    const int count = mImages.size();
+    const float left = float(viewport.left());
+    const float top = float(viewport.top());
+    const float right = float(viewport.left() + viewport.width());
+    const float bottom = float(viewport.top() + viewport.height());
+    const float *itemLeft = mLeft.constData();
+    const float *itemTop = mTop.constData();
+    const float *itemRight = mRight.constData();
+    const float *itemBottom = mBottom.constData();
+
+    QVarLengthArray<uchar, 1024> visible(count);
+    uchar *mask = visible.data();
+    for (int i = 0; i < count; ++i) {
+        mask[i] = uchar((itemLeft[i] < right) & (itemRight[i] > left) & (itemTop[i] < bottom) & (itemBottom[i] > top));
+    }
+
+    const QPointF origin = viewport.topLeft();
+    for (int i = 0; i < count; ++i) {
+        if (mask[i]) {
+            target->compose(mImages.at(i), mPos.at(i) - origin);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef SCENERECORDER_H
+#define SCENERECORDER_H
+
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+#include <QVector>
+
+#include "scenetarget.h"
+
+/*
+ * Display list of one frame. The lanes are composed into it once and it is
+ * replayed into every output, each through its own viewport of the scene, so
+ * outputs share the rasters and the scroll phase of a single compose pass.
+ *
+ * replay() only reads the list and the implicitly shared images, so several
+ * outputs may replay the same frame on different threads.
+ */
+class SceneRecorder : public SceneTarget
+{
+public:
+    SceneRecorder();
+
+    void clear();
+    /* keeps the scroll bands, for a frame that was recorded but never replayed */
+    void clearItems();
+
+    void compose(const QImage &image, const QPointF &pos) override;
+    void scrollBand(const int top, const int height, const int dx) override;
+
+    /* draws the part of the scene inside viewport at the target's origin */
+    void replay(SceneTarget *target, const QRect &viewport) const;
+
+    int itemCount() const { return mImages.size(); }
+
+private:
+    struct Band
+    {
+        int top;
+        int height;
+        int dx;
+    };
+
+    /* items as parallel arrays, so replay() culls them in one tight loop per output */
+    QVector<QImage> mImages;
+    QVector<float> mLeft;
+    QVector<float> mTop;
+    QVector<float> mRight;
+    QVector<float> mBottom;
+    QVector<QPointF> mPos;
+    QVector<Band> mBands;
+};
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef SCENETARGET_H
+#define SCENETARGET_H
+
+class QImage;
+class QPointF;
+
+/*
+ * What lanes, strips and boards draw into: a render backend, or a
+ * SceneRecorder that replays the same frame into several backends.
+ */
+class SceneTarget
+{
+public:
+    virtual ~SceneTarget() {}
+
+    /* the image stays valid until the frame is presented */
+    virtual void compose(const QImage &image, const QPointF &pos) = 0;
+
+    /* rows [top, top + height) moved dx whole pixels since the last frame */
+    virtual void scrollBand(const int top, const int height, const int dx) = 0;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "shapedtextcache.h"
+
+#include <QAtomicInteger>
+#include <QTextLayout>
+#include <QTextOption>
+#include <QThreadStorage>
+
+namespace
+{
+
+QAtomicInteger<qint64> totalBytes;
+QAtomicInteger<quint64> totalHitCount;
+QAtomicInteger<quint64> totalMissCount;
+
+}
+
+ShapedTextCache::ShapedTextCache(const int budgetBytes)
+    : mEntries(budgetBytes)
+    , mHits(0)
+    , mMisses(0)
+{
+}
+
+ShapedTextCache::~ShapedTextCache()
+{
+    totalBytes.fetchAndAddRelaxed(-qint64(mEntries.totalCost()));
+}
+
+ShapedTextCache *ShapedTextCache::global()
+{
+    /* deleted when its thread finishes */
+    static QThreadStorage<ShapedTextCache *> caches;
+    if (!caches.hasLocalData()) {
+        caches.setLocalData(new ShapedTextCache());
+    }
+    return caches.localData();
+}
+
+ShapedTextCache::Entry ShapedTextCache::shape(const QString &text, const QFont &font)
+{
+    const QString cacheKey = key(text, font);
+    if (Entry *entry = mEntries.object(cacheKey)) {
+        ++mHits;
+        totalHitCount.fetchAndAddRelaxed(1);
+        return *entry;
+    }
+    ++mMisses;
+    totalMissCount.fetchAndAddRelaxed(1);
+
+    const Entry entry = shapeUncached(text, font);
+    const int previousCost = mEntries.totalCost();
+    mEntries.insert(cacheKey, new Entry(entry), entry->cost);
+    account(previousCost);
+    return entry;
+}
+
+ShapedTextCache::Entry ShapedTextCache::shapeUncached(const QString &text, const QFont &font)
+{
+    ShapedText *shaped = new ShapedText();
+    shaped->cost = 256 + text.size() * 2;
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    QTextLayout layout(text, font);
+    layout.setTextOption(option);
+    layout.beginLayout();
+    QTextLine line = layout.createLine();
+    if (!line.isValid()) {
+        layout.endLayout();
+        return Entry(shaped);
+    }
+    line.setNumColumns(text.length());
+    layout.endLayout();
+
+    shaped->valid = true;
+    shaped->width = line.naturalTextWidth();
+    shaped->height = line.height();
+    shaped->runs = layout.glyphRuns();
+    for (const QGlyphRun &run : shaped->runs) {
+        /* glyph index plus position, and the run itself */
+        shaped->cost += 64 + run.glyphIndexes().size() * int(sizeof(quint32) + sizeof(QPointF));
+    }
+    return Entry(shaped);
+}
+
+void ShapedTextCache::setBudget(const int bytes)
+{
+    const int previousCost = mEntries.totalCost();
+    mEntries.setMaxCost(bytes);
+    account(previousCost);
+}
+
+void ShapedTextCache::clear()
+{
+    const int previousCost = mEntries.totalCost();
+    mEntries.clear();
+    account(previousCost);
+}
+
+int ShapedTextCache::entryCount() const
+{
+    return mEntries.size();
+}
+
+qint64 ShapedTextCache::byteSize() const
+{
+    return mEntries.totalCost();
+}
+
+quint64 ShapedTextCache::hits() const
+{
+    return mHits;
+}
+
+quint64 ShapedTextCache::misses() const
+{
+    return mMisses;
+}
+
+qint64 ShapedTextCache::totalByteSize()
+{
+    return totalBytes.loadAcquire();
+}
+
+quint64 ShapedTextCache::totalHits()
+{
+    return totalHitCount.loadAcquire();
+}
+
+quint64 ShapedTextCache::totalMisses()
+{
+    return totalMissCount.loadAcquire();
+}
+
+void ShapedTextCache::account(const int previousCost)
+{
+    /* inserting may evict, so the change is whatever the cost moved by */
+    totalBytes.fetchAndAddRelaxed(qint64(mEntries.totalCost()) - previousCost);
+}
+
+QString ShapedTextCache::key(const QString &text, const QFont &font)
+{
+    /* QFont::key() covers family, size, weight, style and the other attributes */
+    return font.key() + QLatin1Char('\n') + text;
+}
@@ -0,0 +1,77 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef SHAPEDTEXTCACHE_H
+#define SHAPEDTEXTCACHE_H
+
+#include <QCache>
+#include <QFont>
+#include <QGlyphRun>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+/*
+ * One line of text shaped by QTextLayout: its glyph runs, positioned from
+ * the top-left of the line box, and the measurements used to place it.
+ */
+struct ShapedText
+{
+    ShapedText() : valid(false), width(0), height(0), cost(0) {}
+
+    bool valid;             // false when no line could be laid out
+    QList<QGlyphRun> runs;
+    qreal width;            // natural text width
+    qreal height;           // line height
+    int cost;               // approximate bytes held
+};
+
+/*
+ * Shaping results keyed by (text, font), so measuring and rasterizing the
+ * same message or segment again skips HarfBuzz and font fallback. Entries are
+ * immutable; the cache is bounded by an approximate byte budget and evicts
+ * least recently used entries.
+ *
+ * The glyph runs hold QRawFonts, which belong to the thread that shaped
+ * them, so a cache and its entries are used by one thread only. global()
+ * gives every thread a cache of its own; the totals add up all of them.
+ */
+class ShapedTextCache
+{
+public:
+    typedef QSharedPointer<const ShapedText> Entry;
+
+    explicit ShapedTextCache(const int budgetBytes = 16 << 20);
+    ~ShapedTextCache();
+
+    /* the calling thread's cache, shared by its strips, boards and image creators */
+    static ShapedTextCache *global();
+
+    Entry shape(const QString &text, const QFont &font);
+    static Entry shapeUncached(const QString &text, const QFont &font);
+
+    void setBudget(const int bytes);
+    void clear();
+
+    int entryCount() const;
+    qint64 byteSize() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+    /* over every cache in the process */
+    static qint64 totalByteSize();
+    static quint64 totalHits();
+    static quint64 totalMisses();
+
+private:
+    static QString key(const QString &text, const QFont &font);
+    void account(const int previousCost);
+
+    QCache<QString, Entry> mEntries;
+    quint64 mHits;
+    quint64 mMisses;
+};
+
+#endif
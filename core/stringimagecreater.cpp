@@ -4,10 +4,14 @@
  */
 
 #include "stringimagecreater.h"
+#include "glyphatlas.h"
+#include "pixelbufferpool.h"
+#include "shapedtextcache.h"
 
 #include <QFont>
 #include <QImage>
 #include <QPainter>
+#include <QGlyphRun>
 
 StringImageCreater::StringImageCreater()
     : mText("")
@@ -16,6 +20,7 @@ StringImageCreater::StringImageCreater()
     , mFont(QFont())
     , mColor(Qt::black)
     , mFontSize(36)
+    , mGlyphAtlas(nullptr)
 {
 }
 
@@ -25,7 +30,12 @@ StringImageCreater::~StringImageCreater()
 
 QImage StringImageCreater::generate()
 {
-    QImage image(QSize(mImageWidth, mImageHeight), QImage::Format_ARGB32_Premultiplied);
+    if (mGlyphAtlas != nullptr) {
+        return generateFromAtlas();
+    }
+
+    QImage image = PixelBufferPool::global()->acquire(QSize(mImageWidth, mImageHeight),
+                                                      QImage::Format_ARGB32_Premultiplied);
     QPainter painter(&image);
     painter.setCompositionMode(QPainter::CompositionMode_Source);
     painter.setBrush(QBrush(QColor(0, 0, 0, 0)));
@@ -38,3 +48,24 @@ QImage StringImageCreater::generate()
     painter.end();
     return image;
 }
+
+QImage StringImageCreater::generateFromAtlas()
+{
+    QImage image = PixelBufferPool::global()->acquire(QSize(mImageWidth, mImageHeight),
+                                                      QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    /* shape once (or reuse an earlier shaping), then compose the cached glyph masks */
+    mFont.setPixelSize(mFontSize);
+    const ShapedTextCache::Entry shaped = ShapedTextCache::global()->shape(mText, mFont);
+    if (!shaped->valid) {
+        return image;
+    }
+
+    /* same placement as drawText() with Qt::AlignLeft | Qt::AlignVCenter */
+    const QPointF origin(0, (mImageHeight - shaped->height) / 2);
+    for (const QGlyphRun &run : shaped->runs) {
+        mGlyphAtlas->drawGlyphRun(image, origin, run, mColor);
+    }
+    return image;
+}
@@ -13,6 +13,8 @@
 #include <QObject>
 #include <stdint.h>
 
+class GlyphAtlas;
+
 class StringImageCreater : public QObject
 {
     Q_OBJECT
@@ -39,16 +41,23 @@ public:
     void setFontSize(const uint32_t size) {
         mFontSize = size;
     }
+    void setGlyphAtlas(GlyphAtlas *atlas) {
+        mGlyphAtlas = atlas;
+    }
 
     QImage generate();
 
 private:
+    QImage generateFromAtlas();
+
+
     QString mText;
     int mImageWidth;
     int mImageHeight;
     QFont mFont;
     QColor mColor;
     uint32_t mFontSize;
+    GlyphAtlas *mGlyphAtlas;
 };
 
 #endif
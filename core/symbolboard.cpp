@@ -0,0 +1,367 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "symbolboard.h"
+#include "glyphatlas.h"
+#include "scenetarget.h"
+#include "pixelbufferpool.h"
+#include "rasterdiskcache.h"
+#include "shapedtextcache.h"
+
+#include <QGlyphRun>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtMath>
+
+#include <algorithm>
+
+class SymbolBoard::SegmentJob : public QRunnable
+{
+public:
+    SegmentJob(GlyphAtlas *atlas, const QFont &font, const int height, const QSharedPointer<ResultQueue> &results,
+               const QString &key, const int segment, const Segment &source, const bool raster)
+        : mAtlas(atlas)
+        , mFont(font)
+        , mHeight(height)
+        , mResults(results)
+        , mKey(key)
+        , mSegment(segment)
+        , mText(source.text)
+        , mColor(source.color)
+        , mVersion(source.version)
+        , mRaster(raster)
+    {
+    }
+
+    void run() override
+    {
+        Result result;
+        result.key = mKey;
+        result.segment = mSegment;
+        result.version = mVersion;
+        result.image = SymbolBoard::rasterizeSegment(mAtlas, mFont, mText, mColor, mHeight, mRaster, &result.width);
+        mResults->push(std::move(result));
+    }
+
+private:
+    GlyphAtlas *mAtlas;
+    QFont mFont;
+    int mHeight;
+    QSharedPointer<ResultQueue> mResults;
+    QString mKey;
+    int mSegment;
+    QString mText;
+    QRgb mColor;
+    quint64 mVersion;
+    bool mRaster;
+};
+
+SymbolBoard::SymbolBoard(GlyphAtlas *atlas)
+    : mGlyphAtlas(atlas)
+    , mThreadPool(nullptr)
+    , mHeight(0)
+    , mTextColor(qRgb(0, 0, 0))
+    , mUpColor(qRgb(0, 160, 60))
+    , mDownColor(qRgb(210, 30, 30))
+    , mVersion(0)
+    , mResults(new ResultQueue())
+    , mPending(0)
+    , mLayoutDirty(false)
+    , mSegmentGap(0)
+    , mLookahead(0.5)
+    , mItemGap(0)
+    , mRasterized(0)
+{
+}
+
+SymbolBoard::~SymbolBoard()
+{
+    qDeleteAll(mItems);
+}
+
+void SymbolBoard::setFont(const QFont &font, const int height)
+{
+    mFont = font;
+    mHeight = height;
+
+    const int em = font.pixelSize() > 0 ? font.pixelSize() : font.pointSize();
+    mSegmentGap = qMax(1, em / 3);
+    mItemGap = em * 2;
+
+    /* every segment has to be measured and rasterized again */
+    for (Item *item : mItems) {
+        for (int i = 0; i < item->segments.size(); ++i) {
+            item->segments[i].version = ++mVersion;
+            schedule(item, i, mResident.contains(item));
+        }
+    }
+    mLayoutDirty = true;
+}
+
+void SymbolBoard::setColors(const QColor &text, const QColor &up, const QColor &down)
+{
+    mTextColor = text.rgba();
+    mUpColor = up.rgba();
+    mDownColor = down.rgba();
+}
+
+void SymbolBoard::update(const QString &key, const QString &text)
+{
+    QMap<QString, Item *>::iterator found = mItems.find(key);
+    if (text.isEmpty()) {
+        if (found != mItems.end()) {
+            mResident.remove(found.value());
+            delete found.value();
+            mItems.erase(found);
+            mLayoutDirty = true;
+        }
+        return;
+    }
+
+    Item *item = nullptr;
+    if (found == mItems.end()) {
+        item = new Item();
+        item->key = key;
+        item->order = -1;
+        item->firstEntry = -1;
+        mItems.insert(key, item);
+        mLayoutDirty = true;
+    } else {
+        item = found.value();
+    }
+
+    QVector<QRgb> colors;
+    const QStringList fields = split(key, text, &colors);
+    if (item->segments.size() != fields.size()) {
+        item->segments.resize(fields.size());
+        mLayoutDirty = true;
+    }
+
+    /* only segments whose text or color changed go back to the rasterizer */
+    const bool resident = mResident.contains(item);
+    for (int i = 0; i < fields.size(); ++i) {
+        Segment &segment = item->segments[i];
+        if (segment.version != 0 && segment.text == fields.at(i) && segment.color == colors.at(i)) {
+            continue;
+        }
+        segment.text = fields.at(i);
+        segment.color = colors.at(i);
+        segment.version = ++mVersion;
+        schedule(item, i, resident);
+    }
+}
+
+int SymbolBoard::width()
+{
+    if (mLayoutDirty) {
+        relayout();
+    }
+    return qCeil(mLayout.extent());
+}
+
+qint64 SymbolBoard::byteSize() const
+{
+    qint64 bytes = 0;
+    for (const Item *item : mResident) {
+        for (const Segment &segment : item->segments) {
+            bytes += segment.image.sizeInBytes();
+        }
+    }
+    return bytes;
+}
+
+void SymbolBoard::compose(SceneTarget *target, const QPointF &pos, const int viewWidth)
+{
+    collect();
+    if (mLayoutDirty) {
+        relayout();
+    }
+    if (mOrder.isEmpty()) {
+        return;
+    }
+
+    /* segments overlapping the window, plus the lookahead */
+    const double left = -pos.x();
+    const double right = viewWidth - pos.x() + viewWidth * mLookahead;
+    int first = 0;
+    int end = 0;
+    mLayout.query(left, right, &first, &end);
+    if (first < end) {
+        evictOutside(mLayout.handle(first), mLayout.handle(end - 1));
+    } else {
+        evictOutside(0, -1);
+    }
+
+    for (int i = first; i < end; ++i) {
+        Item *item = mOrder.at(mLayout.handle(i));
+        mResident.insert(item);
+
+        const int s = i - item->firstEntry;
+        const Segment &segment = item->segments.at(s);
+        if (segment.imageVersion != segment.version) {
+            schedule(item, s, true);
+        }
+
+        /* a stale raster is drawn until its replacement arrives */
+        const double x = pos.x() + mLayout.x(i);
+        if (!segment.image.isNull() && x < viewWidth && x + segment.image.width() > 0) {
+            target->compose(segment.image, QPointF(x, pos.y()));
+        }
+    }
+}
+
+QImage SymbolBoard::rasterizeSegment(GlyphAtlas *atlas, const QFont &font, const QString &text,
+                                     const QRgb color, const int height, const bool raster, int *width)
+{
+    *width = 0;
+
+    /* a segment drawn by an earlier run needs neither shaping nor rasterizing */
+    const quint64 key = RasterDiskCache::key(text, font, color, height);
+    if (raster && height > 0) {
+        const QImage cached = RasterDiskCache::global()->find(key);
+        if (!cached.isNull()) {
+            *width = cached.width();
+            return cached;
+        }
+    }
+
+    const ShapedTextCache::Entry shaped = ShapedTextCache::global()->shape(text, font);
+    if (!shaped->valid) {
+        return QImage();
+    }
+
+    *width = qCeil(shaped->width);
+    if (!raster || *width <= 0 || height <= 0) {
+        return QImage();
+    }
+
+    QImage image = PixelBufferPool::global()->acquire(QSize(*width, height), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    /* same placement as drawText() with Qt::AlignLeft | Qt::AlignVCenter */
+    const QPointF origin(0, (height - shaped->height) / 2);
+    const QColor pen = QColor::fromRgba(color);
+    for (const QGlyphRun &run : shaped->runs) {
+        atlas->drawGlyphRun(image, origin, run, pen);
+    }
+    RasterDiskCache::global()->insert(key, image);
+    return image;
+}
+
+QStringList SymbolBoard::split(const QString &key, const QString &text, QVector<QRgb> *colors) const
+{
+    /* "<price> <change>" -> symbol, price, change, arrow */
+    const QStringList values = text.split(' ', QString::SkipEmptyParts);
+    const QString change = values.size() > 1 ? values.last() : QString();
+    const bool up = change.startsWith('+');
+    const bool down = change.startsWith('-');
+    const QRgb changeColor = up ? mUpColor : (down ? mDownColor : mTextColor);
+
+    QStringList fields;
+    fields << key;
+    colors->append(mTextColor);
+    for (int i = 0; i < values.size(); ++i) {
+        fields << values.at(i);
+        colors->append((i == values.size() - 1) ? changeColor : mTextColor);
+    }
+    if (up || down) {
+        fields << QString(QChar(up ? 0x25B2 : 0x25BC));
+        colors->append(changeColor);
+    }
+    return fields;
+}
+
+void SymbolBoard::schedule(Item *item, const int index, const bool raster)
+{
+    Segment &segment = item->segments[index];
+    if (segment.scheduledVersion == segment.version && (segment.scheduledRaster || !raster)) {
+        return;
+    }
+    segment.scheduledVersion = segment.version;
+    segment.scheduledRaster = raster;
+    ++mPending;
+
+    if (mThreadPool == nullptr) {
+        Result result;
+        result.key = item->key;
+        result.segment = index;
+        result.version = segment.version;
+        result.image = rasterizeSegment(mGlyphAtlas, mFont, segment.text, segment.color, mHeight, raster, &result.width);
+        mResults->push(std::move(result));
+        return;
+    }
+
+    mThreadPool->start(new SegmentJob(mGlyphAtlas, mFont, mHeight, mResults, item->key, index, segment, raster),
+                       raster ? 1 : 0);
+}
+
+void SymbolBoard::collect()
+{
+    Result result;
+    while (mResults->pop(result)) {
+        --mPending;
+        Item *item = mItems.value(result.key);
+        if (item == nullptr || result.segment >= item->segments.size()) {
+            continue;
+        }
+
+        /* results for superseded text are dropped; a newer job is in flight */
+        Segment &segment = item->segments[result.segment];
+        if (result.version != segment.version) {
+            continue;
+        }
+        if (segment.widthVersion != result.version) {
+            segment.width = result.width;
+            segment.widthVersion = result.version;
+            if (!mLayoutDirty && item->firstEntry >= 0) {
+                mLayout.setWidth(item->firstEntry + result.segment, segment.width);
+            }
+        }
+        if (!result.image.isNull() && mResident.contains(item)) {
+            segment.image = result.image;
+            segment.imageVersion = result.version;
+            ++mRasterized;
+        }
+    }
+}
+
+void SymbolBoard::relayout()
+{
+    mOrder.clear();
+    mLayout.clear();
+
+    for (Item *item : mItems) {
+        item->order = mOrder.size();
+        item->firstEntry = mLayout.size();
+        mOrder.append(item);
+
+        const int last = item->segments.size() - 1;
+        for (int s = 0; s <= last; ++s) {
+            mLayout.append(item->segments.at(s).width, (s == last) ? mItemGap : mSegmentGap, item->order);
+        }
+    }
+    mLayoutDirty = false;
+}
+
+void SymbolBoard::evictOutside(const int first, const int last)
+{
+    QSet<Item *>::iterator it = mResident.begin();
+    while (it != mResident.end()) {
+        Item *item = *it;
+        if (item->order >= first && item->order <= last) {
+            ++it;
+            continue;
+        }
+
+        for (Segment &segment : item->segments) {
+            segment.image = QImage();
+            segment.imageVersion = 0;
+            if (segment.scheduledVersion == segment.version) {
+                segment.scheduledRaster = false;
+            }
+        }
+        it = mResident.erase(it);
+    }
+}
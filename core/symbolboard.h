@@ -0,0 +1,141 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef SYMBOLBOARD_H
+#define SYMBOLBOARD_H
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QMap>
+#include <QPointF>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "itemstore.h"
+#include "mpscqueue.h"
+
+class GlyphAtlas;
+class SceneTarget;
+class QThreadPool;
+
+/*
+ * Quote board made of keyed items, each split into segments
+ * (symbol, price, change, arrow) with their own measured width and raster.
+ *
+ * An update only re-measures and re-rasterizes the segments whose text
+ * changed; a new width re-packs the segment row, so everything to the right
+ * just shifts. Rasters are only kept for items near
+ * the window; off-screen updates are measured but not rasterized.
+ */
+class SymbolBoard
+{
+public:
+    explicit SymbolBoard(GlyphAtlas *atlas);
+    ~SymbolBoard();
+
+    void setFont(const QFont &font, const int height);
+    void setColors(const QColor &text, const QColor &up, const QColor &down);
+    void setThreadPool(QThreadPool *pool) {
+        mThreadPool = pool;
+    }
+    /* segments past the right edge kept rasterized, in view widths */
+    void setLookahead(const double views) {
+        mLookahead = qMax(0.0, views);
+    }
+
+    /* an empty text removes the key */
+    void update(const QString &key, const QString &text);
+
+    void compose(SceneTarget *target, const QPointF &pos, const int viewWidth);
+
+    bool isEmpty() const { return mItems.isEmpty(); }
+    int itemCount() const { return mItems.size(); }
+    int width();
+
+    int residentItems() const { return mResident.size(); }
+    int pendingSegments() const { return mPending; }
+    qint64 byteSize() const;
+    quint64 rasterizedSegments() const { return mRasterized; }
+
+private:
+    struct Segment
+    {
+        Segment()
+            : color(0), width(0), version(0), widthVersion(0), imageVersion(0)
+            , scheduledVersion(0), scheduledRaster(false) {}
+
+        QString text;
+        QRgb color;
+        int width;              // measured width of widthVersion
+        QImage image;           // raster of imageVersion, may lag behind version
+        quint64 version;
+        quint64 widthVersion;
+        quint64 imageVersion;
+        quint64 scheduledVersion;
+        bool scheduledRaster;
+    };
+
+    struct Item
+    {
+        QString key;
+        QVector<Segment> segments;
+        int order;              // index into mOrder
+        int firstEntry;         // mLayout entry of the first segment
+    };
+
+    struct Result
+    {
+        QString key;
+        int segment;
+        quint64 version;
+        int width;
+        QImage image;
+    };
+    typedef MpscQueue<Result> ResultQueue;
+
+    class SegmentJob;
+
+    static QImage rasterizeSegment(GlyphAtlas *atlas, const QFont &font, const QString &text,
+                                   const QRgb color, const int height, const bool raster, int *width);
+
+    QStringList split(const QString &key, const QString &text, QVector<QRgb> *colors) const;
+    void schedule(Item *item, const int index, const bool raster);
+    void collect();
+    void relayout();
+    void evictOutside(const int first, const int last);
+
+    GlyphAtlas *mGlyphAtlas;
+    QThreadPool *mThreadPool;
+    QFont mFont;
+    int mHeight;
+    QRgb mTextColor;
+    QRgb mUpColor;
+    QRgb mDownColor;
+
+    QMap<QString, Item *> mItems;
+    quint64 mVersion;
+    QSharedPointer<ResultQueue> mResults;
+    int mPending;
+
+    /*
+     * layout: one mLayout entry per segment, handle = item order. Rebuilt when
+     * items or segments come and go; a width change only re-packs mLayout.
+     */
+    bool mLayoutDirty;
+    QVector<Item *> mOrder;
+    ItemStore mLayout;
+    int mSegmentGap;
+    double mLookahead;
+    int mItemGap;
+
+    QSet<Item *> mResident;
+    quint64 mRasterized;
+};
+
+#endif
@@ -0,0 +1,618 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "tickerengine.h"
+#include "pixelbufferpool.h"
+#include "rasterdiskcache.h"
+#include "renderbackend.h"
+#include "shapedtextcache.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QScreen>
+#include <QThread>
+#include <QWaitCondition>
+#include <QWindow>
+
+class TickerEngine::OutputJob : public QRunnable
+{
+public:
+    OutputJob(RenderBackend *backend, const double sceneTime)
+        : mBackend(backend)
+        , mSceneTime(sceneTime)
+    {
+    }
+
+    void run() override
+    {
+        mBackend->renderFrame(mSceneTime);
+    }
+
+private:
+    RenderBackend *mBackend;
+    double mSceneTime;
+};
+
+/* presents the newest recorded scene whenever the frame loop finished one */
+class TickerEngine::PresentThread : public QThread
+{
+public:
+    explicit PresentThread(TickerEngine *engine)
+        : mEngine(engine)
+        , mPending(false)
+        , mStopping(false)
+    {
+    }
+
+    void notify()
+    {
+        QMutexLocker locker(&mMutex);
+        mPending = true;
+        mCondition.wakeOne();
+    }
+
+    void stop()
+    {
+        {
+            QMutexLocker locker(&mMutex);
+            mStopping = true;
+            mCondition.wakeOne();
+        }
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        for (;;) {
+            {
+                QMutexLocker locker(&mMutex);
+                while (!mPending && !mStopping) {
+                    mCondition.wait(&mMutex);
+                }
+                if (mStopping) {
+                    return;
+                }
+                mPending = false;
+            }
+            mEngine->presentFrame();
+        }
+    }
+
+private:
+    TickerEngine *mEngine;
+    QMutex mMutex;
+    QWaitCondition mCondition;
+    bool mPending;
+    bool mStopping;
+};
+
+TickerEngine::TickerEngine(QObject *parent)
+    : QObject(parent)
+    , mLanes(&mGlyphAtlas, &mRasterPool)
+    , mBackSlot(0)
+    , mFrontSlot(2)
+    , mReadySlot(1)
+    , mPresentThread(nullptr)
+    , mSkippedFrames(0)
+    , mPresentWork(0)
+    , mAdaptiveQuality(true)
+    , mFrameWork(0)
+    , mVSynced(false)
+    , mGaugesTakenAt(-1)
+    , mParallelOutputs(false)
+    , mProfile(Power)
+    , mFrameRate(60.0)
+    , mRunning(false)
+    , mIdle(0)
+    , mWakePending(0)
+    , mIdlePeriods(0)
+    , mIdleSince(0)
+    , mIdleTotal(0)
+{
+    for (int i = 0; i < SceneSlots; ++i) {
+        mSceneTimes[i] = 0.0;
+    }
+
+    /* rasterize tiles off the GUI thread, leaving one core to the frame loop */
+    mRasterPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    /* one 1920x90 lane at 25px/s (the old 0.4px per 16ms frame), 36px Times */
+    mLanes.setWidth(1920);
+    mLanes.addLane("main", 90)->setMessage("Test Message");
+
+    connect(&mPacer, &FramePacer::frame, this, &TickerEngine::onFrame);
+    mMetrics.setSampler([this](FrameMetrics &metrics) { sampleMetrics(metrics); });
+    mStageClock.start();
+    applyProfile();
+
+    /* one queued wake per idle period, however fast records arrive */
+    mFeed.setNotify([this]() {
+        if (mIdle.loadAcquire() && mWakePending.testAndSetOrdered(0, 1)) {
+            QMetaObject::invokeMethod(this, "wake", Qt::QueuedConnection);
+        }
+    });
+}
+
+TickerEngine::~TickerEngine()
+{
+    qDebug() << "[TickerEngine::~TickerEngine] - frames dropped while rasterizing:" << mLanes.droppedFrames();
+    qDebug() << "[TickerEngine::~TickerEngine] - board: items" << mLanes.boardItems()
+             << "segments rasterized" << mLanes.rasterizedSegments();
+    qDebug() << "[TickerEngine::~TickerEngine] - pacing:" << mPacer.report();
+    const PixelBufferPool::Stats pool = PixelBufferPool::global()->stats();
+    qDebug() << "[TickerEngine::~TickerEngine] - pixel pool: hit rate" << PixelBufferPool::global()->hitRate()
+             << "peak" << pool.peakBytes << "bytes";
+    qDebug() << "[TickerEngine::~TickerEngine] - scheduling:" << profileName(mProfile) << "idle"
+             << mIdlePeriods << "times for" << mIdleTotal / 1e9 << "s";
+    qDebug() << "[TickerEngine::~TickerEngine] - quality:" << QualityGovernor::levelName(mGovernor.level())
+             << "after" << mGovernor.transitions() << "transitions";
+    if (pipelined()) {
+        qDebug() << "[TickerEngine::~TickerEngine] - pipeline: skipped" << mSkippedFrames << "frames";
+    }
+    qDebug() << "[TickerEngine::~TickerEngine] - feed: received" << mFeed.received()
+             << "coalesced" << mFeed.coalesced() << "dropped" << mFeed.dropped();
+
+    setPipelined(false);
+    while (!mOutputs.isEmpty()) {
+        removeOutput(mOutputs.last().backend);
+    }
+    mFeed.stop();
+}
+
+void TickerEngine::sampleMetrics(FrameMetrics &metrics)
+{
+    QMutexLocker locker(&mGaugesMutex);
+    for (const Gauge &gauge : mGauges) {
+        metrics.setGauge(gauge.name, gauge.help, gauge.value);
+    }
+}
+
+void TickerEngine::takeGauges(const bool force)
+{
+    const qint64 now = mStageClock.elapsed();
+    if (!force && mGaugesTakenAt >= 0 && now - mGaugesTakenAt < GaugeInterval) {
+        return;
+    }
+    mGaugesTakenAt = now;
+
+    QVector<Gauge> gauges;
+    gauges.reserve(32);
+    const auto gauge = [&gauges](const char *name, const char *help, const double value) {
+        gauges.append({ name, help, value });
+    };
+    gauge("outputs", "Outputs driven by the engine.", mOutputs.size());
+    gauge("lanes", "Ticker lanes.", mLanes.count());
+    gauge("raster_queue_depth", "Tiles and segments waiting for the raster pool.",
+          mLanes.pendingRasters());
+    gauge("feed_queue_depth", "Feed records not yet drained by the frame loop.",
+          mFeed.queueDepth());
+    gauge("strip_cache_bytes", "Bytes held by strip tiles and board segment rasters.",
+          double(mLanes.byteSize()));
+    gauge("glyph_atlas_bytes", "Bytes held by glyph atlas pages.",
+          double(mGlyphAtlas.byteSize()));
+    gauge("shaped_text_bytes", "Bytes held by the shaped text caches of all threads.",
+          double(ShapedTextCache::totalByteSize()));
+    gauge("shaped_text_hits", "Shaping requests answered from the cache.",
+          double(ShapedTextCache::totalHits()));
+    gauge("shaped_text_misses", "Shaping requests that ran QTextLayout.",
+          double(ShapedTextCache::totalMisses()));
+    const PixelBufferPool::Stats pool = PixelBufferPool::global()->stats();
+    gauge("pixel_pool_hit_rate", "Share of image buffers reused from the pixel pool.",
+          PixelBufferPool::global()->hitRate());
+    gauge("pixel_pool_bytes", "Bytes of pooled image buffers, in use and free.",
+          double(pool.inUseBytes + pool.freeBytes));
+    gauge("pixel_pool_peak_bytes", "Highest bytes of pooled image buffers resident at once.",
+          double(pool.peakBytes));
+    gauge("raster_cache_hits", "Tiles and segments read from the on-disk raster cache.",
+          double(RasterDiskCache::global()->hits()));
+    gauge("raster_cache_misses", "Tiles and segments the on-disk raster cache did not have.",
+          double(RasterDiskCache::global()->misses()));
+    gauge("raster_cache_bytes", "Bytes of the on-disk raster cache, mapped and pending.",
+          double(RasterDiskCache::global()->byteSize()));
+    gauge("raster_dropped_frames", "Frames that showed a hole because a tile was not ready.",
+          double(mLanes.droppedFrames()));
+    gauge("pacer_missed_frames", "Frame deadlines skipped because a frame ran late.",
+          double(mPacer.stats().missed));
+    gauge("scheduler_idle", "1 while the frame clock is stopped because nothing moves.",
+          isIdle() ? 1 : 0);
+    gauge("scheduler_idle_periods", "Times the frame clock went idle.", double(mIdlePeriods));
+    gauge("pipeline_skipped_frames", "Recorded frames the present thread had no time for.",
+          double(mSkippedFrames));
+    gauge("quality_level", "Quality steps given up to stay in budget, 0 for full quality.",
+          mGovernor.level());
+    gauge("quality_transitions", "Times the quality governor changed level.",
+          double(mGovernor.transitions()));
+
+    QMutexLocker locker(&mGaugesMutex);
+    mGauges.swap(gauges);
+}
+
+void TickerEngine::addOutput(RenderBackend *backend, const QRect &viewport)
+{
+    if (indexOf(backend) >= 0) {
+        setViewport(backend, viewport);
+        return;
+    }
+
+    Output output;
+    output.backend = backend;
+    output.viewport = viewport;
+
+    /* direct, so the replay runs on whichever thread renders the output; each thread owns its slot */
+    output.rendered = connect(backend, &RenderBackend::rendered, this, [this, backend]() {
+        const int slot = presentsOffThread(backend) ? mFrontSlot : mBackSlot;
+        mScenes[slot].replay(backend, this->viewport(backend));
+    }, Qt::DirectConnection);
+    output.resized = connect(backend, &RenderBackend::widgetResized, this, &TickerEngine::wake);
+    output.destroyed = connect(backend, &QObject::destroyed, this, [this, backend]() {
+        removeOutput(backend);
+    });
+
+    /* the backend's own pacer stays stopped; the engine clock drives it */
+    backend->resetFrameRate(mPacer.frameRate());
+    backend->setRenderActive(true);
+    {
+        QMutexLocker locker(&mOutputsMutex);
+        mOutputs.append(output);
+    }
+    applyProfile();
+    wake();
+}
+
+void TickerEngine::removeOutput(RenderBackend *backend)
+{
+    const int index = indexOf(backend);
+    if (index < 0) {
+        return;
+    }
+
+    /* waits for the present thread to be done with the backend */
+    QMutexLocker locker(&mOutputsMutex);
+    disconnect(mOutputs.at(index).rendered);
+    disconnect(mOutputs.at(index).resized);
+    disconnect(mOutputs.at(index).destroyed);
+    mOutputs.remove(index);
+    locker.unlock();
+    applyProfile();
+}
+
+void TickerEngine::setViewport(RenderBackend *backend, const QRect &viewport)
+{
+    const int index = indexOf(backend);
+    if (index >= 0) {
+        QMutexLocker locker(&mOutputsMutex);
+        mOutputs[index].viewport = viewport;
+        locker.unlock();
+        wake();
+    }
+}
+
+QRect TickerEngine::viewport(RenderBackend *backend) const
+{
+    const int index = indexOf(backend);
+    if (index < 0 || mOutputs.at(index).viewport.isNull()) {
+        return QRect(QPoint(0, 0), mLanes.size());
+    }
+    return mOutputs.at(index).viewport;
+}
+
+void TickerEngine::start()
+{
+    mRunning = true;
+    if (isIdle()) {
+        wake();
+    } else if (!mPacer.isActive()) {
+        mPacer.start();
+    }
+}
+
+void TickerEngine::stop()
+{
+    if (isIdle()) {
+        mIdleTotal += mStageClock.nsecsElapsed() - mIdleSince;
+        mIdle.fetchAndStoreOrdered(0);
+    }
+    mRunning = false;
+    mPacer.stop();
+}
+
+void TickerEngine::setFrameRate(const double fps)
+{
+    if (fps <= 0.0) return;
+
+    /* only the frame cadence changes; scroll speed follows the scene time */
+    mFrameRate = fps;
+    mGovernor.setTargetRate(fps);
+    applyProfile();
+}
+
+void TickerEngine::setProfile(const Profile profile)
+{
+    mProfile = profile;
+    mGovernor.setEnabled(mAdaptiveQuality && mProfile != Throughput);
+    applyQuality();
+    applyProfile();
+    if (mProfile == Throughput) {
+        wake();
+    }
+}
+
+void TickerEngine::setAdaptiveQuality(const bool enabled)
+{
+    mAdaptiveQuality = enabled;
+    mGovernor.setEnabled(mAdaptiveQuality && mProfile != Throughput);
+    applyQuality();
+    applyProfile();
+}
+
+void TickerEngine::setPipelined(const bool enabled)
+{
+    if (enabled == pipelined()) {
+        return;
+    }
+
+    if (enabled) {
+        /* nothing recorded yet is waiting */
+        mReadySlot.fetchAndStoreOrdered(mReadySlot.load() & SlotMask);
+        mPresentThread = new PresentThread(this);
+        mPresentThread->start(QThread::HighPriority);
+    } else {
+        mPresentThread->stop();
+        delete mPresentThread;
+        mPresentThread = nullptr;
+    }
+}
+
+bool TickerEngine::parseProfile(const QString &name, Profile *profile)
+{
+    const QString lower = name.toLower();
+    if (lower == "throughput") {
+        *profile = Throughput;
+    } else if (lower == "latency") {
+        *profile = Latency;
+    } else if (lower == "power") {
+        *profile = Power;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString TickerEngine::profileName(const Profile profile)
+{
+    switch (profile) {
+    case Throughput: return "throughput";
+    case Latency: return "latency";
+    case Power: return "power";
+    }
+    return QString();
+}
+
+int TickerEngine::indexOf(const RenderBackend *backend) const
+{
+    for (int i = 0; i < mOutputs.size(); ++i) {
+        if (mOutputs.at(i).backend == backend) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TickerEngine::applyProfile()
+{
+    /* one output waits for vblank; more would wait one interval each per frame */
+    bool synced = false;
+    for (const Output &output : mOutputs) {
+        const bool vsync = mProfile == Power && !synced && output.backend->supportsVSync();
+        output.backend->setVSync(vsync);
+        synced = synced || vsync;
+    }
+    mVSynced = synced;
+
+    /* a rate between two divisors of the refresh would beat against vblank */
+    double fps = mGovernor.frameRate();
+    const double refresh = synced ? displayRate() : 0.0;
+    if (refresh > 0.0) {
+        fps = refresh / qMax(1, qRound(refresh / fps));
+    }
+
+    mPacer.setSpinWindow(mProfile == Latency ? 1000000 : 0);
+    mPacer.setTimerType(mProfile == Power ? Qt::CoarseTimer : Qt::PreciseTimer);
+    mPacer.setFrameRate(fps);
+    for (const Output &output : mOutputs) {
+        output.backend->resetFrameRate(fps);
+    }
+}
+
+void TickerEngine::applyQuality()
+{
+    mLanes.setQuality(mGovernor.wholePixels(), mGovernor.shortLookahead());
+}
+
+double TickerEngine::displayRate() const
+{
+    for (const Output &output : mOutputs) {
+        if (output.backend->vsync()) {
+            const QWindow *window = output.backend->window()->windowHandle();
+            const QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+            return screen ? screen->refreshRate() : 0.0;
+        }
+    }
+    return 0.0;
+}
+
+bool TickerEngine::presentsOffThread(const RenderBackend *backend) const
+{
+    return mPresentThread != nullptr && backend->rendersOffThread();
+}
+
+bool TickerEngine::settled() const
+{
+    return !mLanes.isMoving() && mLanes.pendingRasters() == 0 && mFeed.queueDepth() == 0;
+}
+
+void TickerEngine::wake()
+{
+    mWakePending.fetchAndStoreOrdered(0);
+    if (!mRunning || !isIdle()) {
+        return;
+    }
+    mIdleTotal += mStageClock.nsecsElapsed() - mIdleSince;
+    mIdle.fetchAndStoreOrdered(0);
+
+    /* the scene clock stood still while idle, so the lanes go on from where they stopped */
+    mPacer.start();
+    mGovernor.restart();
+    onFrame();
+}
+
+void TickerEngine::onFrame()
+{
+    renderFrame(mPacer.sceneTime() / 1e9);
+
+    /* frames rendered outside the pacer do not count against its budget */
+    const double rate = mGovernor.frameRate();
+    if (mGovernor.addFrame(mFrameWork)) {
+        applyQuality();
+        if (mGovernor.frameRate() != rate) {
+            applyProfile();
+        }
+    }
+
+    /* what was just presented stays correct until something changes */
+    if (mProfile == Throughput || !settled()) {
+        return;
+    }
+    mIdle.fetchAndStoreOrdered(1);
+
+    /* a record queued before the flag was set found nothing to wake */
+    if (mFeed.queueDepth() > 0) {
+        mIdle.fetchAndStoreOrdered(0);
+        return;
+    }
+    mPacer.stop();
+    mIdleSince = mStageClock.nsecsElapsed();
+    ++mIdlePeriods;
+    takeGauges(true);
+}
+
+void TickerEngine::renderFrame(const double sceneTime)
+{
+    if (pipelined()) {
+        simulateFrame(sceneTime);
+        return;
+    }
+
+    const qint64 start = mStageClock.nsecsElapsed();
+
+    /* integrate from the frame clock so speed does not depend on frame rate */
+    mLanes.advance(sceneTime);
+
+    /* only the latest value of each key reaches the boards */
+    mLanes.applyUpdates(mFeed.drain());
+
+    const qint64 ticked = mStageClock.nsecsElapsed();
+    SceneRecorder &scene = mScenes[mBackSlot];
+    scene.clear();
+    mLanes.compose(&scene);
+    takeGauges(false);
+
+    /* the lanes are not touched again until every output is done with the scene */
+    const qint64 composed = mStageClock.nsecsElapsed();
+    QVector<RenderBackend *> local;
+    for (const Output &output : mOutputs) {
+        if (mParallelOutputs && output.backend->rendersOffThread()) {
+            mOutputPool.start(new OutputJob(output.backend, sceneTime));
+        } else {
+            local.append(output.backend);
+        }
+    }
+    for (RenderBackend *backend : local) {
+        backend->renderFrame(sceneTime);
+    }
+    mOutputPool.waitForDone();
+
+    const qint64 presented = mStageClock.nsecsElapsed();
+    mFrameWork = (mVSynced ? composed : presented) - start;
+    mMetrics.addFrame(ticked - start, composed - ticked, presented - composed, mPacer.period());
+}
+
+void TickerEngine::simulateFrame(const double sceneTime)
+{
+    const qint64 start = mStageClock.nsecsElapsed();
+    mLanes.advance(sceneTime);
+    mLanes.applyUpdates(mFeed.drain());
+
+    /*
+     * A frame the present thread has not taken yet is taken back and recorded
+     * over, keeping its scroll bands: they reach retained backends with the
+     * very frame published next. If the present thread takes it first, the
+     * exchange fails and the bands went out with it.
+     */
+    const qint64 ticked = mStageClock.nsecsElapsed();
+    const int ready = mReadySlot.loadAcquire();
+    if ((ready & FreshSlot) != 0 && mReadySlot.testAndSetOrdered(ready, mBackSlot)) {
+        mBackSlot = ready & SlotMask;
+        mScenes[mBackSlot].clearItems();
+        ++mSkippedFrames;
+    } else {
+        mScenes[mBackSlot].clear();
+    }
+    mLanes.compose(&mScenes[mBackSlot]);
+    mSceneTimes[mBackSlot] = sceneTime;
+    takeGauges(false);
+
+    const qint64 composed = mStageClock.nsecsElapsed();
+    for (const Output &output : mOutputs) {
+        if (!presentsOffThread(output.backend)) {
+            output.backend->renderFrame(sceneTime);
+        }
+    }
+
+    /* publish; the slot handed back was replayed already, only this loop marks slots fresh */
+    mBackSlot = mReadySlot.fetchAndStoreOrdered(mBackSlot | FreshSlot) & SlotMask;
+    mPresentThread->notify();
+
+    /* the loop is held up by its own work, or falls behind the present thread */
+    const qint64 presented = mStageClock.nsecsElapsed();
+    const qint64 loopWork = (mVSynced ? composed : presented) - start;
+    mFrameWork = qMax(loopWork, mPresentWork.load());
+    mMetrics.addFrame(ticked - start, composed - ticked, presented - composed + mPresentWork.load(), mPacer.period());
+}
+
+void TickerEngine::presentFrame()
+{
+    /* the frame loop may take the slot back meanwhile; it notifies again when it publishes */
+    const int ready = mReadySlot.loadAcquire();
+    if ((ready & FreshSlot) == 0 || !mReadySlot.testAndSetOrdered(ready, mFrontSlot)) {
+        return;
+    }
+    mFrontSlot = ready & SlotMask;
+    const double sceneTime = mSceneTimes[mFrontSlot];
+
+    const qint64 start = mStageClock.nsecsElapsed();
+    QMutexLocker locker(&mOutputsMutex);
+    QVector<RenderBackend *> local;
+    for (const Output &output : mOutputs) {
+        if (!presentsOffThread(output.backend)) {
+            continue;
+        }
+        if (mParallelOutputs) {
+            mOutputPool.start(new OutputJob(output.backend, sceneTime));
+        } else {
+            local.append(output.backend);
+        }
+    }
+    for (RenderBackend *backend : local) {
+        backend->renderFrame(sceneTime);
+    }
+    mOutputPool.waitForDone();
+    locker.unlock();
+
+    mPresentWork.store(mStageClock.nsecsElapsed() - start);
+}
@@ -0,0 +1,213 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef TICKERENGINE_H
+#define TICKERENGINE_H
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QMutex>
+#include <QObject>
+#include <QRect>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include "framepacer.h"
+#include "framemetrics.h"
+#include "glyphatlas.h"
+#include "feedingest.h"
+#include "lanemanager.h"
+#include "qualitygovernor.h"
+#include "scenerecorder.h"
+
+class RenderBackend;
+
+/*
+ * Ticker state shared by any number of outputs: one glyph atlas, raster pool
+ * and feed, one set of lanes and one frame clock.
+ *
+ * Every frame the lanes are advanced and composed once into a SceneRecorder;
+ * each output backend then replays the part of the scene its viewport covers
+ * from its own renderFrame(). Rasterization cost is the same for one output
+ * or many, and all outputs show the same scroll phase. Outputs sized as
+ * slices of a wider scene make a video wall; outputs with the same viewport
+ * mirror each other.
+ *
+ * With parallel outputs on, backends that render off thread do their compose
+ * and present on the output pool while the frame loop waits for all of them.
+ *
+ * Pipelined, the frame loop only simulates and records: each recorded scene
+ * is handed to a present thread through three slots (one being recorded,
+ * one being replayed, the latest finished one in between), and the present
+ * thread composes and presents every off-thread output from the newest
+ * scene. Neither side waits for the other; a frame the present thread had
+ * no time for is skipped, its scroll carried into the next one, and the
+ * scene clock never stops for a slow present. GUI-thread backends still
+ * render in the frame loop.
+ *
+ * The scheduling profile decides how frames are paced:
+ *   Throughput  a frame on every deadline, always; fixed cadence for captures
+ *   Latency     precise deadlines with a spin window, presents without vsync
+ *   Power       coarse timer, vsync where the backend has it, and the rate
+ *               snapped to a divisor of the display refresh
+ * Latency and Power stop the frame clock once a frame left nothing moving
+ * (no lane scrolling, no feed queued, no raster pending) and go idle; a feed
+ * record, wake() or a resized output renders the next frame immediately.
+ *
+ * Under Latency and Power, adaptive quality lets a QualityGovernor give up
+ * sub-pixel phases, lookahead and then frame rate while frames run over
+ * budget, and take them back once there is room again.
+ */
+class TickerEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Profile { Throughput, Latency, Power };
+
+    explicit TickerEngine(QObject *parent = Q_NULLPTR);
+    ~TickerEngine();
+
+    GlyphAtlas *glyphAtlas() { return &mGlyphAtlas; }
+    FeedIngest *feed() { return &mFeed; }
+    LaneManager *lanes() { return &mLanes; }
+    FramePacer *framePacer() { return &mPacer; }
+
+    /* shared tick, compose and output stages of every frame */
+    FrameMetrics *frameMetrics() { return &mMetrics; }
+    /* any thread; the gauges the frame loop took last */
+    void sampleMetrics(FrameMetrics &metrics);
+
+    /* a null viewport shows the whole scene; the backend must be initialized */
+    void addOutput(RenderBackend *backend, const QRect &viewport = QRect());
+    void removeOutput(RenderBackend *backend);
+    void setViewport(RenderBackend *backend, const QRect &viewport);
+    QRect viewport(RenderBackend *backend) const;
+    int outputCount() const { return mOutputs.size(); }
+
+    void setParallelOutputs(const bool enabled) {
+        mParallelOutputs = enabled;
+    }
+    bool parallelOutputs() const { return mParallelOutputs; }
+
+    void setPipelined(const bool enabled);
+    bool pipelined() const { return mPresentThread != nullptr; }
+    /* recorded frames the present thread never showed */
+    quint64 skippedFrames() const { return mSkippedFrames; }
+
+    void start();
+    void stop();
+    /* started and not stopped; an idle engine is still running */
+    bool isRunning() const { return mRunning; }
+    bool isIdle() const { return mIdle.load() != 0; }
+
+    /* the requested rate; Power may pace at a display divisor of it */
+    void setFrameRate(const double fps);
+    double frameRate() const { return mFrameRate; }
+
+    void setProfile(const Profile profile);
+    Profile profile() const { return mProfile; }
+    static bool parseProfile(const QString &name, Profile *profile);
+    static QString profileName(const Profile profile);
+
+    /* on by default; Throughput never adapts */
+    void setAdaptiveQuality(const bool enabled);
+    bool adaptiveQuality() const { return mAdaptiveQuality; }
+    const QualityGovernor &governor() const { return mGovernor; }
+
+    /* one frame at the given scene time, outside the pacer */
+    void renderFrame(const double sceneTime);
+
+public slots:
+    /* leaves idle with a frame right away; any thread through a queued call */
+    void wake();
+
+private slots:
+    void onFrame();
+
+private:
+    struct Output
+    {
+        RenderBackend *backend;
+        QRect viewport;
+        QMetaObject::Connection rendered;
+        QMetaObject::Connection resized;
+        QMetaObject::Connection destroyed;
+    };
+
+    struct Gauge
+    {
+        const char *name;
+        const char *help;
+        double value;
+    };
+
+    class OutputJob;
+    class PresentThread;
+
+    enum { SceneSlots = 3, SlotMask = 3, FreshSlot = 4 };
+    /* ms between gauge snapshots, as often as the HUD redraws */
+    enum { GaugeInterval = 250 };
+
+    int indexOf(const RenderBackend *backend) const;
+    void applyProfile();
+    void applyQuality();
+    double displayRate() const;
+    bool settled() const;
+    bool presentsOffThread(const RenderBackend *backend) const;
+    void simulateFrame(const double sceneTime);
+    void presentFrame();
+    /* frame loop only; the lanes, outputs and governor are not safe to read elsewhere */
+    void takeGauges(const bool force);
+
+    GlyphAtlas mGlyphAtlas;
+    QThreadPool mRasterPool;
+    QThreadPool mOutputPool;
+    FeedIngest mFeed;
+    LaneManager mLanes;
+    SceneRecorder mScenes[SceneSlots];
+    double mSceneTimes[SceneSlots];
+    /* recorded by the frame loop, replayed by the present thread */
+    int mBackSlot;
+    int mFrontSlot;
+    /* the latest finished slot, with FreshSlot until the present thread takes it */
+    QAtomicInt mReadySlot;
+    PresentThread *mPresentThread;
+    quint64 mSkippedFrames;
+    QAtomicInteger<qint64> mPresentWork;
+
+    FramePacer mPacer;
+    FrameMetrics mMetrics;
+    QElapsedTimer mStageClock;
+    QualityGovernor mGovernor;
+    bool mAdaptiveQuality;
+    /* tick to present of the last frame, in ns; without present while an output waits for vblank */
+    qint64 mFrameWork;
+    bool mVSynced;
+    /* snapshot for sampleMetrics(), which the HUD calls from the present thread */
+    QMutex mGaugesMutex;
+    QVector<Gauge> mGauges;
+    qint64 mGaugesTakenAt;
+
+    QVector<Output> mOutputs;
+    /* changes to mOutputs, and the present thread while it walks them */
+    QMutex mOutputsMutex;
+    bool mParallelOutputs;
+
+    Profile mProfile;
+    double mFrameRate;
+    bool mRunning;
+    /* set on the GUI thread when the clock stops; read by feed producers */
+    QAtomicInt mIdle;
+    QAtomicInt mWakePending;
+    quint64 mIdlePeriods;
+    qint64 mIdleSince;
+    qint64 mIdleTotal;
+};
+
+#endif
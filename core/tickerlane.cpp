@@ -0,0 +1,209 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "tickerlane.h"
+#include "scenetarget.h"
+
+#include <QtMath>
+
+TickerLane::TickerLane(const QString &name, GlyphAtlas *atlas, QThreadPool *pool)
+    : mName(name)
+    , mStrip(atlas)
+    , mBoard(atlas)
+    , mPlaylist(atlas)
+    , mFont("Times", 48)
+    , mTop(0)
+    , mSize(1920, 90)
+    , mSpeed(25.0)
+    , mDirection(RightToLeft)
+    , mScrollPos(0.0)
+    , mDrawnScrollPos(0)
+    , mPhases(1)
+    , mWholePixels(false)
+    , mShortLookahead(false)
+{
+    mStrip.setThreadPool(pool);
+    mBoard.setThreadPool(pool);
+    mPlaylist.setThreadPool(pool);
+    mBoard.setColors(Qt::black, QColor(0, 160, 60), QColor(210, 30, 30));
+    applyFont();
+    restart();
+}
+
+TickerLane::~TickerLane()
+{
+}
+
+void TickerLane::setGeometry(const int top, const QSize &size)
+{
+    /* moving a lane keeps its content and position */
+    mTop = top;
+    if (size == mSize) {
+        return;
+    }
+
+    mSize = size;
+    applyFont();
+    restart();
+}
+
+void TickerLane::setFontFamily(const QString &family)
+{
+    mFont.setFamily(family);
+    applyFont();
+}
+
+void TickerLane::setDirection(const Direction direction)
+{
+    mDirection = direction;
+    restart();
+}
+
+void TickerLane::setSubpixelPhases(const int phases)
+{
+    mPhases = phases;
+    applyQuality();
+}
+
+void TickerLane::setQuality(const bool wholePixels, const bool shortLookahead)
+{
+    mWholePixels = wholePixels;
+    mShortLookahead = shortLookahead;
+    applyQuality();
+}
+
+void TickerLane::applyQuality()
+{
+    const int phases = mWholePixels ? 1 : mPhases;
+    mStrip.setPhases(phases);
+    mPlaylist.setPhases(phases);
+
+    /* one item or tile ahead still hides most rasterization; the board keeps an eighth of a window */
+    mStrip.setLookahead(mShortLookahead ? 1 : 2);
+    mPlaylist.setLookahead(mShortLookahead ? 1 : 2);
+    mBoard.setLookahead(mShortLookahead ? 0.125 : 0.5);
+}
+
+void TickerLane::setMessage(const QString &text)
+{
+    mMessage = text;
+    mStrip.setText(mMessage, mFont, Qt::black, mSize.height());
+}
+
+void TickerLane::setPlaylist(const QStringList &items, const int gap)
+{
+    mPlaylist.setItems(items);
+    mPlaylist.setGap(gap);
+    restart();
+}
+
+void TickerLane::update(const QString &key, const QString &text)
+{
+    mBoard.update(key, text);
+}
+
+void TickerLane::advance(const double seconds)
+{
+    const double distance = mSpeed * seconds;
+    mScrollPos += (mDirection == RightToLeft) ? -distance : distance;
+}
+
+bool TickerLane::isMoving()
+{
+    const bool playlist = mBoard.isEmpty() && !mPlaylist.isEmpty();
+    return mSpeed != 0.0 && !mSize.isEmpty() && (playlist || contentWidth() > 0);
+}
+
+void TickerLane::compose(SceneTarget *target)
+{
+    /* tell retained backends how far this lane moved */
+    const int drawnScrollPos = qFloor(mScrollPos + 0.5);
+    target->scrollBand(mTop, mSize.height(), drawnScrollPos - mDrawnScrollPos);
+    mDrawnScrollPos = drawnScrollPos;
+
+    const QPointF pos(mScrollPos, mTop);
+    if (!mBoard.isEmpty()) {
+        mBoard.compose(target, pos, mSize.width());
+    } else if (!mPlaylist.isEmpty()) {
+        mPlaylist.compose(target, travel(), mTop, mSize.width(), mDirection == LeftToRight);
+    } else {
+        mStrip.compose(target, pos, mSize.width(), mDirection == LeftToRight);
+    }
+
+    wrap();
+}
+
+void TickerLane::seek(const double seconds)
+{
+    restart();
+    advance(seconds);
+    wrap();
+
+    /* nothing drawn yet at the new position, so no scroll distance to report */
+    mDrawnScrollPos = qFloor(mScrollPos + 0.5);
+}
+
+void TickerLane::applyFont()
+{
+    /* keep the 36px per 90px proportion of the original strip */
+    mFont.setPixelSize(qMax(1, mSize.height() * 2 / 5));
+    mStrip.setText(mMessage, mFont, Qt::black, mSize.height());
+    mBoard.setFont(mFont, mSize.height());
+    mPlaylist.setStyle(mFont, Qt::black, mSize.height());
+}
+
+int TickerLane::contentWidth()
+{
+    return mBoard.isEmpty() ? mStrip.width() : mBoard.width();
+}
+
+void TickerLane::wrap()
+{
+    /*
+     * A playlist loops seamlessly, so only whole loops are taken off. Loops
+     * are whole pixels and look the same, so retained backends keep scrolling.
+     */
+    if (mBoard.isEmpty() && !mPlaylist.isEmpty()) {
+        const double before = mScrollPos;
+        setTravel(mPlaylist.wrap(travel()));
+        mDrawnScrollPos += qRound(mScrollPos - before);
+        return;
+    }
+
+    /*
+     * The content scrolls fully off before it comes back, and the overshoot
+     * is kept, so the position stays a pure function of time and content.
+     */
+    const double period = mSize.width() + contentWidth();
+    if (period <= 0) {
+        return;
+    }
+    if (mDirection == RightToLeft && mScrollPos < -contentWidth()) {
+        mScrollPos += period * qCeil((-contentWidth() - mScrollPos) / period);
+    } else if (mDirection == LeftToRight && mScrollPos > mSize.width()) {
+        mScrollPos -= period * qCeil((mScrollPos - mSize.width()) / period);
+    }
+}
+
+void TickerLane::restart()
+{
+    if (mBoard.isEmpty() && !mPlaylist.isEmpty()) {
+        /* the first item enters at the window edge */
+        setTravel(-mSize.width());
+        return;
+    }
+    mScrollPos = (mDirection == RightToLeft) ? mSize.width() : -contentWidth();
+}
+
+double TickerLane::travel() const
+{
+    /* chain position at the edge items leave by; they enter at travel + width */
+    return (mDirection == RightToLeft) ? -mScrollPos : mScrollPos - mSize.width();
+}
+
+void TickerLane::setTravel(const double travel)
+{
+    mScrollPos = (mDirection == RightToLeft) ? -travel : travel + mSize.width();
+}
@@ -0,0 +1,107 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef TICKERLANE_H
+#define TICKERLANE_H
+
+#include <QFont>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include "tiledstrip.h"
+#include "symbolboard.h"
+#include "playlist.h"
+
+class GlyphAtlas;
+class SceneTarget;
+class QThreadPool;
+
+/*
+ * One horizontal crawl: a message strip, or a playlist of messages chained
+ * back to back, replaced by a symbol board once the lane receives feed items,
+ * scrolling at its own speed and direction inside its band of the window.
+ * Lanes hold no timer; LaneManager advances and composes all of them once
+ * per frame.
+ */
+class TickerLane
+{
+public:
+    enum Direction { RightToLeft, LeftToRight };
+
+    TickerLane(const QString &name, GlyphAtlas *atlas, QThreadPool *pool);
+    ~TickerLane();
+
+    QString name() const { return mName; }
+
+    /* band of the window; the font is scaled to the height */
+    void setGeometry(const int top, const QSize &size);
+    int top() const { return mTop; }
+    QSize size() const { return mSize; }
+
+    void setFontFamily(const QString &family);
+    void setSpeed(const double pixelsPerSecond) {
+        mSpeed = pixelsPerSecond;
+    }
+    double speed() const { return mSpeed; }
+    void setDirection(const Direction direction);
+    Direction direction() const { return mDirection; }
+
+    /* sub-pixel phases of the message and playlist strips; boards stay on whole pixels */
+    void setSubpixelPhases(const int phases);
+
+    /* cheaper drawing while frames run over budget, see QualityGovernor */
+    void setQuality(const bool wholePixels, const bool shortLookahead);
+
+    void setMessage(const QString &text);
+    QString message() const { return mMessage; }
+
+    /* shown instead of the message while not empty; restarts the lane */
+    void setPlaylist(const QStringList &items, const int gap = 200);
+
+    /* an empty text removes the key */
+    void update(const QString &key, const QString &text);
+
+    void advance(const double seconds);
+    /* whether advancing changes what the lane shows */
+    bool isMoving();
+
+    /* position after the given time since the lane (re)started, wraps included */
+    void seek(const double seconds);
+    void compose(SceneTarget *target);
+
+    const TiledStrip &strip() const { return mStrip; }
+    const SymbolBoard &board() const { return mBoard; }
+    const Playlist &playlist() const { return mPlaylist; }
+
+private:
+    void applyFont();
+    int contentWidth();
+    void restart();
+    void wrap();
+    double travel() const;
+    void setTravel(const double travel);
+    void applyQuality();
+
+    QString mName;
+    TiledStrip mStrip;
+    SymbolBoard mBoard;
+    Playlist mPlaylist;
+    QString mMessage;
+    QFont mFont;
+
+    int mTop;
+    QSize mSize;
+    double mSpeed;
+    Direction mDirection;
+    double mScrollPos;
+    int mDrawnScrollPos;
+
+    int mPhases;
+    bool mWholePixels;
+    bool mShortLookahead;
+};
+
+#endif
@@ -0,0 +1,375 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "tiledstrip.h"
+#include "glyphatlas.h"
+#include "scenetarget.h"
+#include "pixelbufferpool.h"
+#include "rasterdiskcache.h"
+#include "shapedtextcache.h"
+
+#include <QGlyphRun>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtMath>
+
+#include <algorithm>
+
+class TiledStrip::TileJob : public QRunnable
+{
+public:
+    TileJob(const QSharedPointer<const Layout> &layout, const QSharedPointer<ResultQueue> &results,
+            const quint64 generation, const int index)
+        : mLayout(layout)
+        , mResults(results)
+        , mGeneration(generation)
+        , mIndex(index)
+    {
+    }
+
+    void run() override
+    {
+        TileResult result;
+        result.generation = mGeneration;
+        result.index = mIndex;
+        result.images = TiledStrip::rasterizeTile(*mLayout, mIndex);
+        mResults->push(std::move(result));
+    }
+
+private:
+    QSharedPointer<const Layout> mLayout;
+    QSharedPointer<ResultQueue> mResults;
+    quint64 mGeneration;
+    int mIndex;
+};
+
+TiledStrip::TiledStrip(GlyphAtlas *atlas, const int tileWidth)
+    : mGlyphAtlas(atlas)
+    , mTileWidth(tileWidth)
+    , mLookahead(2)
+    , mThreadPool(nullptr)
+    , mResults(new ResultQueue())
+    , mGeneration(0)
+    , mDroppedFrames(0)
+{
+    Layout *layout = new Layout();
+    layout->atlas = atlas;
+    layout->overhang = 0;
+    layout->color = 0;
+    layout->cacheKey = 0;
+    layout->tileWidth = tileWidth;
+    layout->width = 0;
+    layout->height = 0;
+    layout->phases = 1;
+    mLayout = QSharedPointer<const Layout>(layout);
+}
+
+TiledStrip::~TiledStrip()
+{
+}
+
+void TiledStrip::setText(const QString &text, const QFont &font, const QColor &color, const int height)
+{
+    Layout *layout = new Layout();
+    layout->atlas = mGlyphAtlas;
+    layout->overhang = 0;
+    layout->color = qPremultiply(color.rgba());
+    layout->cacheKey = RasterDiskCache::key(RasterDiskCache::key(text, font, layout->color, height), mTileWidth);
+    layout->tileWidth = mTileWidth;
+    layout->width = 0;
+    layout->height = height;
+    layout->phases = mLayout->phases;
+    publish(layout);
+
+    const ShapedTextCache::Entry shaped = ShapedTextCache::global()->shape(text, font);
+    if (!shaped->valid) {
+        return;
+    }
+
+    /* same placement as drawText() with Qt::AlignLeft | Qt::AlignVCenter */
+    const QPointF origin(0, (height - shaped->height) / 2);
+    layout->overhang = shaped->height;
+    layout->width = qCeil(shaped->width);
+
+    for (const QGlyphRun &run : shaped->runs) {
+        /* workers rasterize by id; the raw font itself stays on this thread */
+        const int font = mGlyphAtlas->fontId(run.rawFont());
+
+        const QVector<quint32> indexes = run.glyphIndexes();
+        const QVector<QPointF> positions = run.positions();
+        for (int i = 0; i < indexes.size(); ++i) {
+            GlyphRef ref;
+            ref.font = font;
+            ref.index = indexes.at(i);
+            ref.pos = origin + positions.at(i);
+            layout->glyphs.append(ref);
+        }
+    }
+    std::sort(layout->glyphs.begin(), layout->glyphs.end(), [](const GlyphRef &a, const GlyphRef &b) {
+        return a.pos.x() < b.pos.x();
+    });
+}
+
+void TiledStrip::setPhases(const int phases)
+{
+    const int clamped = qBound(1, phases, int(MaxPhases));
+    if (clamped == mLayout->phases) {
+        return;
+    }
+
+    /* the glyphs stay, only the tiles are drawn again */
+    Layout *layout = new Layout(*mLayout);
+    layout->phases = clamped;
+    publish(layout);
+}
+
+void TiledStrip::publish(Layout *layout)
+{
+    /* results of jobs still in flight are dropped by generation */
+    ++mGeneration;
+    mPending.clear();
+    if (mThreadPool != nullptr) {
+        const QList<int> keys = mTiles.keys();
+        for (const int key : keys) {
+            mStaleTiles.insert(key, *mTiles.object(key));
+        }
+    }
+    mTiles.clear();
+    mLayout = QSharedPointer<const Layout>(layout);
+}
+
+void TiledStrip::compose(SceneTarget *target, const QPointF &pos, const int viewWidth, const bool leftToRight)
+{
+    collect();
+
+    const int width = mLayout->width;
+    if (width <= 0 || mLayout->height <= 0) {
+        return;
+    }
+
+    /* the cache only has to hold the visible tiles plus the lookahead, every phase of them */
+    const int phases = mLayout->phases;
+    const int capacity = (viewWidth / mTileWidth + 2 + mLookahead) * phases;
+    if (mTiles.maxCost() != capacity) {
+        mTiles.setMaxCost(capacity);
+    }
+
+    /* the whole pixel the tiles are placed at and the phase covering the rest */
+    double x = pos.x();
+    int phase = 0;
+    if (phases > 1) {
+        const double base = qFloor(x);
+        phase = qRound((x - base) * phases);
+        x = (phase == phases) ? base + 1.0 : base;
+        phase %= phases;
+    }
+
+    /* the strip has scrolled out of the window for good */
+    const double left = qMax(0.0, -pos.x());
+    const double right = qMin(double(width), viewWidth - pos.x());
+    if (leftToRight ? viewWidth - pos.x() <= 0.0 : left >= width) {
+        mTiles.clear();
+        return;
+    }
+
+    /* last < first while the strip has not reached the window; tiles enter at the leading side */
+    int first = 0;
+    int last = -1;
+    if (right > left) {
+        first = int(left) / mTileWidth;
+        last = (qCeil(right) - 1) / mTileWidth;
+    } else if (leftToRight) {
+        first = tileCount();
+        last = first - 1;
+    }
+    if (leftToRight) {
+        evictOutside(first - mLookahead, last);
+    } else {
+        evictOutside(first, last + mLookahead);
+    }
+
+    bool missing = false;
+    bool stale = false;
+    for (int i = first; i <= last; ++i) {
+        Tile images = tile(i, 1);
+        if (images.isEmpty()) {
+            images = mStaleTiles.value(i);
+            stale = stale || !images.isEmpty();
+        }
+        if (images.isEmpty()) {
+            missing = true;
+            continue;
+        }
+        /* stale tiles may have been drawn with another phase count */
+        const QImage &image = images.at(phase * images.size() / phases);
+        target->compose(image, QPointF(x + i * mTileWidth, pos.y()));
+    }
+    if (missing) {
+        ++mDroppedFrames;
+    }
+    if (!stale) {
+        mStaleTiles.clear();
+    }
+
+    /* rasterize the tiles about to scroll in before they are needed */
+    for (int n = 1; n <= mLookahead; ++n) {
+        const int i = leftToRight ? first - n : last + n;
+        if (i < 0 || i >= tileCount()) {
+            break;
+        }
+        if (!mTiles.contains(i)) {
+            tile(i, 0);
+        }
+    }
+}
+
+void TiledStrip::prefetch(const bool fromEnd)
+{
+    collect();
+    if (mLayout->width <= 0 || mLayout->height <= 0) {
+        return;
+    }
+
+    const int count = qMin(qMax(1, mLookahead), tileCount());
+    for (int n = 0; n < count; ++n) {
+        const int i = fromEnd ? tileCount() - 1 - n : n;
+        if (!mTiles.contains(i)) {
+            tile(i, 0);
+        }
+    }
+}
+
+qint64 TiledStrip::byteSize() const
+{
+    return qint64(mTiles.totalCost()) * mTileWidth * mLayout->height * 4;
+}
+
+TiledStrip::Tile TiledStrip::rasterizeTile(const Layout &layout, const int index)
+{
+    const int x0 = index * layout.tileWidth;
+    const int width = qMin(layout.tileWidth, layout.width - x0);
+    const bool lastTile = x0 + width >= layout.width;
+    Tile images(layout.phases);
+
+    /* a tile drawn by an earlier run is copied, not drawn again; phase 0 keeps the whole-pixel key */
+    const quint64 tileKey = RasterDiskCache::key(layout.cacheKey, index);
+    QImage source;
+    for (int phase = 0; phase < layout.phases; ++phase) {
+        const quint64 key = (phase == 0) ? tileKey : RasterDiskCache::key(RasterDiskCache::key(tileKey, phase), layout.phases);
+        images[phase] = RasterDiskCache::global()->find(key);
+        if (!images.at(phase).isNull()) {
+            continue;
+        }
+
+        if (layout.phases == 1) {
+            images[phase] = rasterizeSpan(layout, x0, width);
+        } else {
+            /* one pixel either side, so the shift pulls in the neighbouring tiles' ink */
+            if (source.isNull()) {
+                source = rasterizeSpan(layout, x0 - 1, width + 2);
+            }
+            /* the last tile grows by a pixel so the shifted right edge is not cut */
+            images[phase] = shiftImage(source, (phase > 0 && lastTile) ? width + 1 : width, phase, layout.phases);
+        }
+        RasterDiskCache::global()->insert(key, images.at(phase));
+    }
+    return images;
+}
+
+QImage TiledStrip::rasterizeSpan(const Layout &layout, const int x0, const int width)
+{
+    QImage image = PixelBufferPool::global()->acquire(QSize(width, layout.height), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    /* glyphs whose ink may reach into [x0, x0 + width) */
+    GlyphRef probe;
+    probe.pos = QPointF(x0 - layout.overhang, 0);
+    QVector<GlyphRef>::const_iterator it = std::lower_bound(
+        layout.glyphs.constBegin(), layout.glyphs.constEnd(), probe, [](const GlyphRef &a, const GlyphRef &b) {
+            return a.pos.x() < b.pos.x();
+        });
+
+    const qreal end = x0 + width + layout.overhang;
+    const QPointF shift(x0, 0);
+    for (; it != layout.glyphs.constEnd() && it->pos.x() < end; ++it) {
+        const GlyphAtlas::Glyph glyph = layout.atlas->glyph(it->font, it->index);
+        layout.atlas->drawGlyph(image, it->pos - shift, glyph, layout.color);
+    }
+    return image;
+}
+
+QImage TiledStrip::shiftImage(const QImage &source, const int width, const int phase, const int phases)
+{
+    /*
+     * Column x of the result is source columns x and x + 1 (source starts one
+     * pixel left of the tile) blended phase : phases - phase. Premultiplied
+     * channels blend linearly, so every byte is the same two-tap filter.
+     */
+    QImage image = PixelBufferPool::global()->acquire(QSize(width, source.height()), QImage::Format_ARGB32_Premultiplied);
+    const uint own = uint(phases - phase);
+    const uint carried = uint(phase);
+    const uint half = uint(phases) / 2;
+    const int bytes = width * 4;
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar *left = source.constScanLine(y);
+        const uchar *right = left + 4;
+        uchar *dst = image.scanLine(y);
+        for (int i = 0; i < bytes; ++i) {
+            dst[i] = uchar((right[i] * own + left[i] * carried + half) / uint(phases));
+        }
+    }
+    return image;
+}
+
+TiledStrip::Tile TiledStrip::tile(const int index, const int priority)
+{
+    Tile *cached = mTiles.object(index);
+    if (cached != nullptr) {
+        return *cached;
+    }
+
+    if (mThreadPool == nullptr) {
+        const Tile images = rasterizeTile(*mLayout, index);
+        mTiles.insert(index, new Tile(images), images.size());
+        return images;
+    }
+
+    if (!mPending.contains(index)) {
+        mPending.insert(index);
+        mThreadPool->start(new TileJob(mLayout, mResults, mGeneration, index), priority);
+    }
+    return Tile();
+}
+
+void TiledStrip::collect()
+{
+    TileResult result;
+    while (mResults->pop(result)) {
+        if (result.generation != mGeneration) {
+            continue;
+        }
+        mPending.remove(result.index);
+        mTiles.insert(result.index, new Tile(result.images), result.images.size());
+    }
+}
+
+void TiledStrip::evictOutside(const int first, const int last)
+{
+    const QList<int> keys = mTiles.keys();
+    for (const int key : keys) {
+        if (key < first || key > last) {
+            mTiles.remove(key);
+        }
+    }
+
+    QHash<int, Tile>::iterator it = mStaleTiles.begin();
+    while (it != mStaleTiles.end()) {
+        if (it.key() < first || it.key() > last) {
+            it = mStaleTiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef TILEDSTRIP_H
+#define TILEDSTRIP_H
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QPointF>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "mpscqueue.h"
+
+class GlyphAtlas;
+class SceneTarget;
+class QThreadPool;
+
+/*
+ * A message strip split into fixed-width tiles.
+ * The text is shaped once; tiles are rasterized from the glyph atlas only when
+ * they enter the visible window (plus a lookahead margin) and are evicted as
+ * soon as they scroll off, so memory follows the window width, not the text.
+ *
+ * With a thread pool set, tiles are rasterized on the pool and handed back to
+ * the frame loop through a lock-free queue; compose() never waits for them and
+ * counts a dropped frame whenever a visible tile is not ready yet. After
+ * setText() the previous tiles stay on screen until their replacements arrive.
+ *
+ * With several sub-pixel phases, every tile is kept shifted right by
+ * 0, 1/n, ..., (n-1)/n of a pixel. The shifts are resampled once when the
+ * tile is rasterized; compose() places the phase nearest to the fractional
+ * position at a whole pixel, so slow crawls move smoothly at blit cost and
+ * n times the tile memory.
+ */
+class TiledStrip
+{
+public:
+    explicit TiledStrip(GlyphAtlas *atlas, const int tileWidth = 256);
+    ~TiledStrip();
+
+    void setText(const QString &text, const QFont &font, const QColor &color, const int height);
+    void setLookahead(const int tiles) {
+        mLookahead = tiles;
+    }
+    void setThreadPool(QThreadPool *pool) {
+        mThreadPool = pool;
+    }
+
+    /* 1 draws at whole pixels; at most MaxPhases */
+    void setPhases(const int phases);
+    int phases() const { return mLayout->phases; }
+
+    enum { MaxPhases = 16 };
+
+    int width() const { return mLayout->width; }
+    int height() const { return mLayout->height; }
+    int tileWidth() const { return mTileWidth; }
+    int tileCount() const { return (mLayout->width + mTileWidth - 1) / mTileWidth; }
+
+    /* leftToRight: the strip moves right, so its tiles enter from the end first */
+    void compose(SceneTarget *target, const QPointF &pos, const int viewWidth, const bool leftToRight);
+
+    /* queues the lookahead tiles at the edge that scrolls in first: the start, or the end */
+    void prefetch(const bool fromEnd);
+
+    int residentTiles() const { return mTiles.size(); }
+    int pendingTiles() const { return mPending.size(); }
+    qint64 byteSize() const;
+    quint64 droppedFrames() const { return mDroppedFrames; }
+
+private:
+    struct GlyphRef
+    {
+        int font;       // GlyphAtlas font id
+        quint32 index;
+        QPointF pos;    // pen position in strip coordinates
+    };
+
+    /* shaped text; immutable once published so workers can share it */
+    struct Layout
+    {
+        GlyphAtlas *atlas;
+        QVector<GlyphRef> glyphs;  // sorted by pen x
+        qreal overhang;
+        quint32 color;
+        quint64 cacheKey;   // RasterDiskCache key of the whole strip
+        int tileWidth;
+        int width;
+        int height;
+        int phases;
+    };
+
+    /* one image per phase */
+    typedef QVector<QImage> Tile;
+
+    struct TileResult
+    {
+        quint64 generation;
+        int index;
+        Tile images;
+    };
+    typedef MpscQueue<TileResult> ResultQueue;
+
+    class TileJob;
+
+    static Tile rasterizeTile(const Layout &layout, const int index);
+    static QImage rasterizeSpan(const Layout &layout, const int x0, const int width);
+    static QImage shiftImage(const QImage &source, const int width, const int phase, const int phases);
+
+    Tile tile(const int index, const int priority);
+    void publish(Layout *layout);
+    void collect();
+    /* drops every tile outside [first, last] */
+    void evictOutside(const int first, const int last);
+
+    GlyphAtlas *mGlyphAtlas;
+    int mTileWidth;
+    int mLookahead;
+    QThreadPool *mThreadPool;
+
+    QSharedPointer<const Layout> mLayout;
+    QSharedPointer<ResultQueue> mResults;
+    quint64 mGeneration;
+    QSet<int> mPending;
+    quint64 mDroppedFrames;
+
+    QCache<int, Tile> mTiles;
+    QHash<int, Tile> mStaleTiles;
+};
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#include "uploadmanager.h"
+
+#include <QColor>
+
+#include <cstring>
+
+namespace {
+/* frames a texture stays resident after its image was last composed */
+const quint64 RetireFrames = 3;
+
+void convertRow(uchar *dst, const uchar *src, const int width, const UploadManager::Format format)
+{
+    const quint32 *in = reinterpret_cast<const quint32 *>(src);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (format == UploadManager::BGRA8) {
+        std::memcpy(dst, src, size_t(width) * 4);
+        return;
+    }
+
+    /* ARGB32 words are B, G, R, A in memory; swapping R and B gives R, G, B, A */
+    quint32 *out = reinterpret_cast<quint32 *>(dst);
+    for (int x = 0; x < width; ++x) {
+        const quint32 p = in[x];
+        out[x] = (p & 0xff00ff00u) | ((p >> 16) & 0xffu) | ((p & 0xffu) << 16);
+    }
+#else
+    const bool rgba = (format == UploadManager::RGBA8);
+    for (int x = 0; x < width; ++x, dst += 4) {
+        const quint32 p = in[x];
+        dst[0] = uchar(rgba ? qRed(p) : qBlue(p));
+        dst[1] = uchar(qGreen(p));
+        dst[2] = uchar(rgba ? qBlue(p) : qRed(p));
+        dst[3] = uchar(qAlpha(p));
+    }
+#endif
+}
+}
+
+UploadManager::UploadManager(const Format format, const int ringSize)
+    : mFormat(format)
+    , mRingSize(qMax(1, ringSize))
+    , mNextSlot(0)
+    , mFrame(0)
+    , mFrameBytes(0)
+{
+    std::memset(&mStats, 0, sizeof(mStats));
+}
+
+UploadManager::~UploadManager()
+{
+    /* subclasses release their textures themselves; the hooks are gone by now */
+}
+
+const char *UploadManager::formatName(const Format format)
+{
+    return (format == BGRA8) ? "bgra8" : "rgba8";
+}
+
+void UploadManager::beginFrame()
+{
+    ++mFrame;
+    mFrameBytes = 0;
+}
+
+int UploadManager::upload(const QImage &source)
+{
+    if (source.isNull()) {
+        return -1;
+    }
+
+    const qint64 serial = source.cacheKey() >> 32;
+    QHash<qint64, Resident>::iterator it = mResident.find(serial);
+    if (it != mResident.end() && it->cacheKey == source.cacheKey()) {
+        it->lastUsed = mFrame;
+        return it->texture;
+    }
+
+    /* the kernels read premultiplied ARGB32; anything else is converted once */
+    const QImage image = (source.format() == QImage::Format_ARGB32_Premultiplied)
+        ? source : source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    /* the same image written to since: only rows whose hash changed */
+    if (it != mResident.end() && it->size == image.size()) {
+        QVector<uint> hashes;
+        hashRows(image, &hashes);
+        bool sent = true;
+        int y = 0;
+        while (y < image.height()) {
+            if (hashes.at(y) == it->rowHashes.at(y)) {
+                ++y;
+                ++mStats.rowsSkipped;
+                continue;
+            }
+            int end = y + 1;
+            while (end < image.height() && hashes.at(end) != it->rowHashes.at(end)) {
+                ++end;
+            }
+            sent = send(image, it->texture, y, end - y) && sent;
+            y = end;
+        }
+        it->lastUsed = mFrame;
+
+        /* rows that did not arrive must differ from the recorded hashes next time */
+        if (sent) {
+            it->rowHashes = hashes;
+            it->cacheKey = source.cacheKey();
+            ++mStats.updates;
+        }
+        return it->texture;
+    }
+
+    if (it != mResident.end()) {
+        releaseTexture(it->texture);
+        mStats.textureBytes -= qint64(it->size.width()) * it->size.height() * 4;
+        mResident.erase(it);
+    }
+
+    Resident resident;
+    resident.texture = createTexture(image.size());
+    if (resident.texture < 0) {
+        return -1;
+    }
+    resident.size = image.size();
+    resident.cacheKey = source.cacheKey();
+    resident.lastUsed = mFrame;
+    hashRows(image, &resident.rowHashes);
+    if (!send(image, resident.texture, 0, image.height())) {
+        releaseTexture(resident.texture);
+        return -1;
+    }
+    mResident.insert(serial, resident);
+    mStats.textureBytes += qint64(image.width()) * image.height() * 4;
+    ++mStats.uploads;
+    return resident.texture;
+}
+
+void UploadManager::endFrame()
+{
+    QHash<qint64, Resident>::iterator it = mResident.begin();
+    while (it != mResident.end()) {
+        if (mFrame - it->lastUsed >= RetireFrames) {
+            releaseTexture(it->texture);
+            mStats.textureBytes -= qint64(it->size.width()) * it->size.height() * 4;
+            it = mResident.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    ++mStats.frames;
+    mStats.lastFrameBytes = mFrameBytes;
+    mStats.peakFrameBytes = qMax(mStats.peakFrameBytes, mFrameBytes);
+}
+
+void UploadManager::clear()
+{
+    for (const Resident &resident : mResident) {
+        releaseTexture(resident.texture);
+    }
+    mResident.clear();
+    mStats.textureBytes = 0;
+}
+
+UploadManager::Stats UploadManager::stats() const
+{
+    Stats stats = mStats;
+    stats.textures = mResident.size();
+    return stats;
+}
+
+void UploadManager::hashRows(const QImage &image, QVector<uint> *hashes) const
+{
+    hashes->resize(image.height());
+    const size_t rowBytes = size_t(image.width()) * 4;
+    for (int y = 0; y < image.height(); ++y) {
+        (*hashes)[y] = qHashBits(image.constScanLine(y), rowBytes);
+    }
+}
+
+bool UploadManager::send(const QImage &image, const int texture, const int first, const int count)
+{
+    /* the ring gives the device time to finish reading a buffer before it is filled again */
+    const int slot = mNextSlot;
+    mNextSlot = (mNextSlot + 1) % mRingSize;
+
+    const QSize size(image.width(), count);
+    const Staging staging = mapStaging(slot, size);
+    if (staging.bits == nullptr) {
+        return false;
+    }
+    for (int y = 0; y < count; ++y) {
+        convertRow(staging.bits + qint64(y) * staging.bytesPerLine, image.constScanLine(first + y), image.width(), mFormat);
+    }
+    copyStaging(slot, texture, QRect(QPoint(0, first), size));
+
+    const qint64 bytes = qint64(image.width()) * count * 4;
+    mFrameBytes += bytes;
+    mStats.bytes += quint64(bytes);
+    mStats.rows += quint64(count);
+    return true;
+}
+
+SoftwareUploadManager::SoftwareUploadManager(const Format format, const int ringSize)
+    : UploadManager(format, ringSize)
+    , mStaging(qMax(1, ringSize))
+{
+}
+
+SoftwareUploadManager::~SoftwareUploadManager()
+{
+    clear();
+}
+
+QImage::Format SoftwareUploadManager::imageFormat() const
+{
+    return (format() == BGRA8) ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGBA8888_Premultiplied;
+}
+
+int SoftwareUploadManager::createTexture(const QSize &size)
+{
+    const QImage texture(size, imageFormat());
+    if (texture.isNull()) {
+        return -1;
+    }
+    if (!mFreeTextures.isEmpty()) {
+        const int index = mFreeTextures.takeLast();
+        mTextures[index] = texture;
+        return index;
+    }
+    mTextures.append(texture);
+    return mTextures.size() - 1;
+}
+
+void SoftwareUploadManager::releaseTexture(const int texture)
+{
+    mTextures[texture] = QImage();
+    mFreeTextures.append(texture);
+}
+
+UploadManager::Staging SoftwareUploadManager::mapStaging(const int slot, const QSize &size)
+{
+    /* buffers only grow, so the ring settles at the largest upload and stops allocating */
+    QImage &staging = mStaging[slot];
+    if (staging.width() < size.width() || staging.height() < size.height()) {
+        staging = QImage(size.expandedTo(staging.size()), imageFormat());
+    }
+
+    Staging result;
+    result.bits = staging.bits();
+    result.bytesPerLine = staging.bytesPerLine();
+    return result;
+}
+
+void SoftwareUploadManager::copyStaging(const int slot, const int texture, const QRect &rect)
+{
+    const QImage &staging = mStaging.at(slot);
+    QImage &target = mTextures[texture];
+    const size_t rowBytes = size_t(rect.width()) * 4;
+    for (int y = 0; y < rect.height(); ++y) {
+        std::memcpy(target.scanLine(rect.y() + y) + rect.x() * 4, staging.constScanLine(y), rowBytes);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+#ifndef UPLOADMANAGER_H
+#define UPLOADMANAGER_H
+
+#include <QHash>
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+/*
+ * Keeps the images a backend composes resident as textures in the backend's
+ * own pixel format.
+ *
+ * Images are tracked by QImage::cacheKey(): an image seen before costs nothing,
+ * and an image written to since its last upload (same serial, new detach
+ * count) only sends the rows whose hash changed. Rows travel through a ring
+ * of persistent staging buffers that already hold the destination byte order,
+ * so the BGRA to RGBA swizzle happens once while filling the buffer and no
+ * resource is created per upload. Textures no image used for a few frames are
+ * released.
+ *
+ * Backends implement the texture and staging hooks; the manager is used by
+ * the thread rendering the backend's frames only.
+ */
+class UploadManager
+{
+public:
+    /* byte order of one pixel in memory */
+    enum Format { BGRA8, RGBA8 };
+
+    struct Stats
+    {
+        quint64 frames;
+        quint64 uploads;        // images sent in full
+        quint64 updates;        // images with only changed rows sent
+        quint64 rows;           // rows sent
+        quint64 rowsSkipped;    // rows of updated images that were unchanged
+        quint64 bytes;          // sent, cumulative
+        qint64 lastFrameBytes;
+        qint64 peakFrameBytes;
+        int textures;
+        qint64 textureBytes;
+    };
+
+    explicit UploadManager(const Format format, const int ringSize = 3);
+    virtual ~UploadManager();
+
+    Format format() const { return mFormat; }
+    static const char *formatName(const Format format);
+
+    void beginFrame();
+    /* the texture holding image, after sending what changed; -1 if it cannot be created or filled */
+    int upload(const QImage &image);
+    void endFrame();
+
+    /* releases every texture, e.g. before the device goes away */
+    void clear();
+
+    Stats stats() const;
+
+protected:
+    struct Staging
+    {
+        uchar *bits;
+        int bytesPerLine;
+    };
+
+    /* a texture of size in the destination format, or -1 */
+    virtual int createTexture(const QSize &size) = 0;
+    virtual void releaseTexture(const int texture) = 0;
+
+    /* room for size pixels in staging buffer slot; null bits if none */
+    virtual Staging mapStaging(const int slot, const QSize &size) = 0;
+    /* the first rect.size() pixels of the slot go to rect of the texture */
+    virtual void copyStaging(const int slot, const int texture, const QRect &rect) = 0;
+
+private:
+    struct Resident
+    {
+        int texture;
+        QSize size;
+        qint64 cacheKey;
+        QVector<uint> rowHashes;
+        quint64 lastUsed;
+    };
+
+    void hashRows(const QImage &image, QVector<uint> *hashes) const;
+    bool send(const QImage &image, const int texture, const int first, const int count);
+
+    Format mFormat;
+    int mRingSize;
+    int mNextSlot;
+
+    /* by QImage serial, the upper half of the cache key */
+    QHash<qint64, Resident> mResident;
+    quint64 mFrame;
+
+    Stats mStats;
+    qint64 mFrameBytes;
+};
+
+/*
+ * Textures as images in host memory, so the upload path (swizzle, ring,
+ * dirty rows) runs and can be measured without a GPU. Defaults to the RGBA
+ * order of the d3d11 swap chain so the cost matches a device upload.
+ */
+class SoftwareUploadManager : public UploadManager
+{
+public:
+    explicit SoftwareUploadManager(const Format format = RGBA8, const int ringSize = 3);
+    ~SoftwareUploadManager();
+
+    /* the destination pixels of a texture */
+    const QImage &texture(const int texture) const { return mTextures.at(texture); }
+
+protected:
+    int createTexture(const QSize &size) override;
+    void releaseTexture(const int texture) override;
+    Staging mapStaging(const int slot, const QSize &size) override;
+    void copyStaging(const int slot, const int texture, const QRect &rect) override;
+
+private:
+    QImage::Format imageFormat() const;
+
+    QVector<QImage> mTextures;
+    QVector<int> mFreeTextures;
+    QVector<QImage> mStaging;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @copyright Copyright (c) Yuji Iwanaga
+ * @date 17th Oct. 2026
+ */
+
+/*
+ * Every compositing kernel set this CPU can run against the scalar reference.
+ *
+ * Counts 0 to 9 cover the short spans and every tail of the 4 and 8 pixel
+ * vector loops; 1024 to 1031 cover every tail after a long vector run. Spans
+ * start on an aligned and on an odd pixel. Sources are all opaque, all zero
+ * or mixed, so the SIMD paths that skip or copy whole vectors run as well as
+ * the per-pixel blend. The pixels past the span must stay untouched.
+ */
+
+#include "composite.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtTest>
+
+Q_DECLARE_METATYPE(const CompositeKernels *)
+
+namespace
+{
+
+enum Pattern { Opaque, Zero, Mixed };
+
+const int Guard = 8;
+
+quint32 premultiplied(QRandomGenerator &random, const quint32 alpha)
+{
+    const quint32 r = random.bounded(alpha + 1);
+    const quint32 g = random.bounded(alpha + 1);
+    const quint32 b = random.bounded(alpha + 1);
+    return (alpha << 24) | (r << 16) | (g << 8) | b;
+}
+
+quint32 pixel(QRandomGenerator &random, const Pattern pattern)
+{
+    switch (pattern) {
+    case Opaque:
+        return premultiplied(random, 255);
+    case Zero:
+        return 0;
+    case Mixed:
+        break;
+    }
+
+    /* the edge alphas are the ones the kernels treat specially */
+    switch (random.bounded(4)) {
+    case 0:
+        return 0;
+    case 1:
+        return premultiplied(random, 255);
+    default:
+        return premultiplied(random, random.bounded(256));
+    }
+}
+
+uchar coverage(QRandomGenerator &random, const Pattern pattern)
+{
+    switch (pattern) {
+    case Opaque:
+        return 255;
+    case Zero:
+        return 0;
+    case Mixed:
+        break;
+    }
+
+    switch (random.bounded(4)) {
+    case 0:
+        return 0;
+    case 1:
+        return 255;
+    default:
+        return uchar(random.bounded(256));
+    }
+}
+
+QVector<quint32> destination(QRandomGenerator &random, const int size)
+{
+    QVector<quint32> pixels(size);
+    for (quint32 &p : pixels) {
+        p = premultiplied(random, random.bounded(256));
+    }
+    return pixels;
+}
+
+const char *patternName(const Pattern pattern)
+{
+    return (pattern == Opaque) ? "opaque" : (pattern == Zero) ? "zero" : "mixed";
+}
+
+}
+
+class CompositeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sourceOver_data() { addRows(); }
+    void sourceOver();
+    void fill_data() { addRows(); }
+    void fill();
+    void maskOver_data() { addRows(); }
+    void maskOver();
+
+private:
+    void addRows();
+};
+
+void CompositeTest::addRows()
+{
+    QTest::addColumn<const CompositeKernels *>("kernels");
+    QTest::addColumn<int>("pattern");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("offset");
+
+    QVector<int> counts;
+    for (int count = 0; count <= 9; ++count) {
+        counts << count;
+    }
+    for (int count = 1024; count <= 1031; ++count) {
+        counts << count;
+    }
+
+    for (const CompositeKernels *kernels : Composite::available()) {
+        for (const Pattern pattern : { Opaque, Zero, Mixed }) {
+            for (const int count : counts) {
+                for (const int offset : { 0, 1 }) {
+                    QTest::addRow("%s/%s/%d+%d", kernels->name, patternName(pattern), count, offset)
+                        << kernels << int(pattern) << count << offset;
+                }
+            }
+        }
+    }
+}
+
+void CompositeTest::sourceOver()
+{
+    QFETCH(const CompositeKernels *, kernels);
+    QFETCH(int, pattern);
+    QFETCH(int, count);
+    QFETCH(int, offset);
+
+    QRandomGenerator random(quint32(count * 8 + pattern * 2 + offset));
+    const int size = offset + count + Guard;
+    QVector<quint32> src(size);
+    for (quint32 &p : src) {
+        p = pixel(random, Pattern(pattern));
+    }
+    QVector<quint32> expected = destination(random, size);
+    QVector<quint32> actual = expected;
+
+    Composite::scalar().sourceOver(expected.data() + offset, src.constData() + offset, count);
+    kernels->sourceOver(actual.data() + offset, src.constData() + offset, count);
+    QCOMPARE(actual, expected);
+}
+
+void CompositeTest::fill()
+{
+    QFETCH(const CompositeKernels *, kernels);
+    QFETCH(int, pattern);
+    QFETCH(int, count);
+    QFETCH(int, offset);
+
+    QRandomGenerator random(quint32(count * 8 + pattern * 2 + offset));
+    const int size = offset + count + Guard;
+    const quint32 color = pixel(random, Pattern(pattern));
+    QVector<quint32> expected = destination(random, size);
+    QVector<quint32> actual = expected;
+
+    Composite::scalar().fill(expected.data() + offset, color, count);
+    kernels->fill(actual.data() + offset, color, count);
+    QCOMPARE(actual, expected);
+}
+
+void CompositeTest::maskOver()
+{
+    QFETCH(const CompositeKernels *, kernels);
+    QFETCH(int, pattern);
+    QFETCH(int, count);
+    QFETCH(int, offset);
+
+    QRandomGenerator random(quint32(count * 8 + pattern * 2 + offset));
+    const int size = offset + count + Guard;
+    QVector<uchar> mask(size);
+    for (uchar &c : mask) {
+        c = coverage(random, Pattern(pattern));
+    }
+
+    /* an opaque and a translucent color, so both blends of the full coverage path run */
+    for (const quint32 color : { premultiplied(random, 255), premultiplied(random, 128) }) {
+        QVector<quint32> expected = destination(random, size);
+        QVector<quint32> actual = expected;
+
+        Composite::scalar().maskOver(expected.data() + offset, mask.constData() + offset, color, count);
+        kernels->maskOver(actual.data() + offset, mask.constData() + offset, color, count);
+        QCOMPARE(actual, expected);
+    }
+}
+
+QTEST_APPLESS_MAIN(CompositeTest)
+
+#include "compositetest.moc"